@@ -82,6 +82,34 @@
 	01 Nov 2021 : Added macro raw mode.
 	18 Nov 2021 : Added mac_indent, mac_list for AutoIndent, AutoList macros.
 	20 Nov 2021 : Added mac_sym for macros.
+	17 Oct 2026 : Added lp_gap. Use GetLine() to read lines.
+	17 Oct 2026 : LoopDeleteEx(), LoopPaste() work on the whole block at once.
+	17 Oct 2026 : Added line storage variables. Use LineAlloc() for the clipboard.
+	17 Oct 2026 : Use LineLen() instead of strlen() for text lines.
+	17 Oct 2026 : Added lp_max. The lines array grows as needed. Print its size.
+	17 Oct 2026 : Added swap file variables and te_swap module. Use PeekLine() in LoopFind().
+	17 Oct 2026 : Include fread() instead of fgets(), and mem.h.
+	17 Oct 2026 : Added la_map. Include fsize().
+	17 Oct 2026 : Added rd_... variables. Read the file progressively in Loop(), read it all when needed.
+	17 Oct 2026 : Added shadow screen variables. Unselect the block before the refresh in LoopDeleteEx().
+	17 Oct 2026 : Added output buffer variables. Flush the output before exit.
+	17 Oct 2026 : Scroll the editor box with ScrollBoxUp(), ScrollBoxDown() when possible.
+	17 Oct 2026 : Added sh_defer. Refresh the rows left for later in Loop().
+	17 Oct 2026 : Added ps_val. Print the information fields only if they changed.
+	17 Oct 2026 : Setting the block start or end keeps the other one. Refresh only the rows whose selection changed.
+	17 Oct 2026 : Added cursor position variables.
+	17 Oct 2026 : Added statistics variables.
+	17 Oct 2026 : Added key traces: te_trace module, trace variables, -R and -P options.
+	17 Oct 2026 : Support for CRT_RESIZE and OS_POSIX. Print the information fields with ShowInfo().
+	17 Oct 2026 : Added rd_tail.
+	17 Oct 2026 : Added compiled macros variables. Removed mac_raw.
+	17 Oct 2026 : Added sh_hold. Don't clear the rest of the line in LoopCr() while it's set.
+	17 Oct 2026 : Added fe_rep. LoopUp(), LoopDown(), LoopDelete(), LoopPaste() do the repeats at once.
+	17 Oct 2026 : Added batch mode: te_batch module, batch variables, -m option. Added ErrStart().
+	17 Oct 2026 : The arguments of main() are pointers under OS_POSIX.
+	17 Oct 2026 : Added rd_idle.
+	17 Oct 2026 : Added rd_put.
+	17 Oct 2026 : LoopBottom() and LoopFind() print the filename again if the file can't be read.
 
 	Notes:
 
@@ -90,16 +118,23 @@
 
 /* Libraries
    ---------
+   The POSIX adaptation includes its own ones.
 */
-#define CC_FGETS
+#ifndef OS_POSIX
+
+#define CC_FREAD
+#define CC_FSIZE
 #define CC_FPUTS
 
 #include <mescc.h>
 #include <string.h>
 #include <ctype.h>
 #include <fileio.h>
+#include <mem.h>
 #include <sprintf.h>
 
+#endif
+
 /* TE definitions
    --------------
 */
@@ -118,6 +153,55 @@ WORD *lp_arr; /* Text lines pointers array */
 int   lp_now; /* How many lines are in the array */
 int   lp_cur; /* Current line */
 int   lp_chg; /* 0 if no changes are made */
+int   lp_gap; /* Gap position in the array, see te_lines.c */
+int   lp_max; /* How many lines fit in the array */
+
+/* Line storage -- see te_misc.c
+   ------------------------------
+*/
+char *la_chunks;           /* Chunks list */
+char *la_ptr;              /* Free space in current chunk */
+char *la_end;              /* End of current chunk */
+WORD  la_free[LA_CLASSES]; /* Free records lists by size class */
+unsigned int la_bytes;     /* Bytes in free records */
+unsigned int la_used;      /* # of records in use */
+unsigned int la_size;      /* Bytes in chunks */
+char *la_map;              /* File read in place, or NULL -- see ReadFile() */
+
+/* File being read -- see te_file.c
+   --------------------------------
+*/
+FILE *rd_fp;               /* File, or NULL if it was read completely */
+unsigned char *rd_buf;     /* Buffer */
+unsigned int rd_size;      /* Buffer size */
+unsigned int rd_beg;       /* Start of current line in buffer */
+unsigned int rd_end;       /* Current character in buffer */
+unsigned int rd_top;       /* End of data in buffer */
+int rd_eof;                /* NZ if there is no more data to read */
+int rd_map;                /* NZ if the file is read in place */
+int rd_crlf;               /* NZ if the previous line ended with CR + LF */
+unsigned int rd_put;       /* ZERO of the previous line read in place -- see ReadMore() */
+int rd_tabs;               /* # of TABs changed to SPACEs */
+int rd_rare;               /* # of illegal characters changed to '?' */
+int rd_tail;               /* # of lines after the ones being read -- see InsertFile() */
+int rd_idle;               /* NZ if GetKey() can read more lines while waiting -- see BfEdit() */
+
+#if OPT_SWAP
+
+/* Swap file -- see te_swap.c
+   ---------------------------
+*/
+char sw_fcb[36];           /* FCB */
+char sw_rec[128];          /* Record buffer */
+int  sw_recno;             /* Record # in buffer, or -1 */
+int  sw_dirty;             /* NZ if the record buffer was modified */
+int  sw_open;              /* 1 if the swap file is open, -1 if it can't be created */
+unsigned int sw_units;     /* Next free unit */
+int  sw_clock;             /* Last line checked by SwapOut() */
+int  sw_last;              /* Last line read by GetLine() */
+unsigned char *sw_dat;     /* Buffer for swapped out lines */
+
+#endif
 
 /* Current line
    ------------
@@ -155,6 +239,85 @@ int box_rows; /* Height in lines */
 int box_shr;  /* Vertical   position of cursor in the box (0..box_rows - 1) */
 int box_shc;  /* Horizontal position of cursor in the box (0..cf_cols - 1) */
 
+/* Shadow screen -- see te_ui.c
+   ----------------------------
+*/
+char *sh_txt; /* Characters on each row of the editor box, plus a work row */
+int  *sh_len; /* # of characters on each row, or -1 if unknown */
+char *sh_sel; /* NZ on each row if it was printed in reverse */
+int   sh_defer; /* NZ if some rows were left for later, because there were keys waiting */
+int   sh_hold;  /* NZ while a macro runs: nothing is printed -- see RefreshScreen() */
+
+/* Cursor position -- see Locate()
+   -------------------------------
+*/
+int cr_row; /* Row, or -1 if unknown */
+int cr_col; /* Column */
+
+#if OPT_STATS
+
+/* Statistics -- see te_ui.c
+   -------------------------
+*/
+unsigned int st_now[ST_MAX];  /* Counters for the current key */
+unsigned int st_last[ST_MAX]; /* Counters for the last key */
+unsigned int st_top[ST_MAX];  /* Max. counters for a key */
+unsigned int st_tot[ST_MAX];  /* Total counters */
+unsigned int st_keys;         /* # of keys */
+
+#endif
+
+#if OPT_TRACE
+
+/* Key traces -- see te_trace.c
+   ----------------------------
+*/
+FILE *tr_fp;              /* Trace file */
+int tr_mode;              /* TR_RECORD, TR_PLAY, or 0 */
+unsigned int tr_keys;     /* # of keys */
+unsigned int tr_out;      /* Characters sent to the CRT, modulo 10000 */
+unsigned int tr_out10k;   /* Characters sent to the CRT, / 10000 */
+unsigned int tr_sum;      /* Checksum of the text */
+unsigned int tr_time;     /* Start time in seconds */
+
+#endif
+
+#if OPT_BATCH
+
+/* Batch mode -- see te_batch.c
+   ----------------------------
+*/
+int bt_mode;   /* NZ in batch mode */
+char *bt_name; /* Current filename, for the error messages */
+int bt_errs;   /* # of errors */
+
+#endif
+
+#if CRT_RESIZE
+
+/* Screen resize -- see te_ui.c
+   ----------------------------
+*/
+int rs_rows;  /* New # of rows, or 0 if there is no change */
+int rs_cols;  /* New # of columns */
+
+#endif
+
+#if CRT_OUT_BUF
+
+/* Output buffer -- see te_ui.c
+   ----------------------------
+*/
+char co_buf[CRT_OUT_SIZ]; /* Data */
+int  co_len;              /* # of characters in buffer */
+
+#endif
+
+/* Information line
+   ----------------
+*/
+int ps_val[PS_FIELDS]; /* Value printed in each field, or -1 if unknown -- see ShowField() */
+
 /* Keyboard forced entry
    ---------------------
 */
@@ -163,6 +326,7 @@ int fe_now;    /* How many characters are now in the buffer */
 int fe_set;    /* Set position */
 int fe_get;    /* Get position */
 int fe_forced; /* Flag: true if forced character on input */
+int fe_rep;    /* # of repeats of the last key -- see ForceRep() */
 
 /* System line
    -----------
@@ -188,9 +352,15 @@ char find_str[FIND_MAX];
 /* Macros
    ------
 */
-FILE *mac_fp;              /* FP for a file macro, or NULL */
-/*char *mac_str;*/ /* Address for a string macro, or NULL */
-int mac_raw;               /* NZ for raw mode */
+FILE *mac_fp;              /* FP for the macro file being compiled */
+unsigned char *mac_pc;     /* Next command of the running macro, or NULL */
+unsigned char *mac_code;   /* Commands of the macro being compiled, or NULL to count them */
+int mac_len;               /* # of bytes of commands */
+int mac_max;               /* Room for commands in mac_code */
+int mac_lit;               /* Position of the length of the last MC_TEXT command */
+int mac_run;               /* # of characters in the last MC_TEXT command, or ZERO */
+WORD mac_cache[MAC_CACHE]; /* Compiled macros, or NULL -- see te_macro.c */
+int mac_next;              /* Next entry of mac_cache to replace */
 unsigned char mac_indent;  /* Value of cf_indent */
 unsigned char mac_list;    /* Value of cf_list */
 char mac_sym[MAC_SYM_SIZ]; /* Macro symbol */
@@ -227,17 +397,39 @@ int help_items[] = {
 #include "te_misc.c"
 #include "te_error.c"
 
+#if OPT_SWAP
+
+#include "te_swap.c"
+
+#endif
+
 #if OPT_MACRO
 
 #include "te_macro.c"
 
 #endif
 
+#if OPT_TRACE
+
+#include "te_trace.c"
+
+#endif
+
+#if OPT_BATCH
+
+#include "te_batch.c"
+
+#endif
+
 /* Program entry
    -------------
 */
 main(argc, argv)
+#ifdef OS_POSIX
+int argc; char *argv[];
+#else
 int argc, argv[];
+#endif
 {
 	int i;
 	
@@ -248,8 +440,20 @@ int argc, argv[];
 	cf_rows = GetScrConf(0, cf_rows, CRT_DEF_ROWS);
 	cf_cols = GetScrConf(1, cf_cols, CRT_DEF_COLS);
 	
+#if OPT_BATCH
+
+	/* Check for batch mode, that has no CRT -- see te_batch.c */
+	if(argc > 1 && BatchArgs(argv[1]))
+		bt_mode = 1;
+	else
+		CrtSetup();
+
+#else
+
 	/* Setup CRT */
 	CrtSetup();
+
+#endif
 	
 	/* Setup some globals */
 #if CRT_LONG	
@@ -262,14 +466,23 @@ int argc, argv[];
 	ln_max = cf_cols - cf_num - 1;
 
 	/* Print layout */
+#if OPT_BATCH
+
+	if(!bt_mode)
+		Layout();
+
+#else
+
 	Layout();
 
+#endif
+
 	/* Allocate buffers -- FIXME -- use AllocMem() ?? */
 	ln_dat = malloc(ln_max + 2);
 
 	fe_dat = malloc(FORCED_MAX * SIZEOF_INT);
 
-	lp_arr = malloc(cf_mx_lines * SIZEOF_PTR);
+	lp_arr = malloc((lp_max = cf_mx_lines) * SIZEOF_PTR);
 
 	i = 1;
 
@@ -295,9 +508,28 @@ int argc, argv[];
 
 	if(i)
 	{
-		ErrLineMem(); CrtReset(); return 1;
+		return ErrStart();
 	}
 
+#if OPT_SWAP
+
+	if(!(sw_dat = malloc(ln_max + 2))) {
+		return ErrStart();
+	}
+
+#endif
+
+	/* Shadow screen */
+	sh_txt = malloc((box_rows + 1) * cf_cols + 1);
+	sh_len = malloc(box_rows * SIZEOF_INT);
+	sh_sel = malloc(box_rows);
+
+	if(!sh_txt || !sh_len || !sh_sel) {
+		return ErrStart();
+	}
+
+	ShadowReset();
+
 	/* Setup clipboard */
 #if OPT_BLOCK
 
@@ -310,12 +542,26 @@ int argc, argv[];
 
 #endif
 
-	/* Setup lines */
-	for(i = 0; i < cf_mx_lines; ++i) {
-		lp_arr[i] = NULL;
-	}
+#if OPT_BATCH
+
+	/* Apply the macro to the files, and exit */
+	if(bt_mode)
+		return BatchRun(argc, argv);
+
+#endif
 
 	/* Check command line */
+#if OPT_TRACE
+
+	if(argc > 2 && TraceArgs(argv[1], argv[2])) {
+		for(i = 1; i < argc - 2; ++i)
+			argv[i] = argv[i + 2];
+
+		argc -= 2;
+	}
+
+#endif
+
 	if(argc == 1)
 	{
 		NewFile();
@@ -335,22 +581,72 @@ int argc, argv[];
 	}
 	else
 	{
+#if OPT_TRACE
+
+		ErrLine("Bad command line. Use: te [-R|-P trace] [filename]");
+
+#else
+
 		ErrLine("Bad command line. Use: te [filename]");
 
+#endif
+
 		NewFile();
 	}
 
 	/* Main loop */
 	Loop();
 
+#if OPT_TRACE
+
+	/* Close the trace file, get the checksum */
+	TraceEnd();
+
+#endif
+
+#if OPT_SWAP
+
+	/* Remove the swap file */
+	SwapClose();
+
+#endif
+
 	/* Clear & reset CRT */
 	CrtClear();
+	CrtFlush();
 	CrtReset();
 
+#if OPT_TRACE
+
+	/* Print the results of the playback */
+	TraceReport();
+
+#endif
+
 	/* Exit */
 	return 0;
 }
 
+/* Out of memory on start
+   ----------------------
+   Returns the exit code -- see main().
+*/
+ErrStart()
+{
+	ErrLineMem();
+
+#if OPT_BATCH
+
+	if(bt_mode)
+		return 1;
+
+#endif
+
+	CrtReset();
+
+	return 1;
+}
+
 /* Get # of rows / columns on auto configuration value
    ---------------------------------------------------
 */
@@ -395,30 +691,42 @@ Loop()
 	/* Loop */
 	while(run)
 	{
-		/* Refresh system line message if it changed */
-		if(sysln)
+		/* Read more lines of the file, if it's being read: enough
+		   for the next page, and a few more each time */
+		if(rd_fp)
 		{
-			SysLineEdit();
-
-			sysln = 0;
+			/* On error, the filename was cleared -- see ReadMore() */
+			if(ReadMore(lp_cur + box_rows + box_rows) || ReadMore(lp_now + RD_SLICE))
+				ShowFilename();
 		}
 
-		/* Print clipboard status */
-		CrtLocate(PS_ROW, PS_CLP);
+#if CRT_RESIZE
 
-#if OPT_BLOCK
+		/* Resize the screen, if it was resized in a menu, etc. */
+		if(rs_rows)
+			ResizeScreen();
 
-	putstr(clp_count ? "CLP" : "---");
+#endif
 
-#else
+		/* Refresh the rows left for later: all of them if there are
+		   no keys waiting, else the cursor one only -- see Refresh() */
+		if(sh_defer)
+		{
+			sh_defer = 0;
 
-	putstr(*clp_line ? "CLP" : "---");
+			RefreshAll();
+		}
 
-#endif
+		/* Refresh system line message if it changed */
+		if(sysln)
+		{
+			SysLineEdit();
 
-		/* Print current line number, etc. */
-		CrtLocate(PS_ROW, PS_LIN_CUR); putint("%04d", lp_cur + 1);
-		CrtLocate(PS_ROW, PS_LIN_NOW); putint("%04d", lp_now);
+			sysln = 0;
+		}
+
+		/* Print clipboard status, current line number, etc. */
+		ShowInfo();
 
 		/* Edit the line */
 		ch = BfEdit();
@@ -508,6 +816,12 @@ Loop()
 #endif
 
 			case K_ESC :   /* Show the menu ------------------- */
+#if OPT_BATCH
+				if(bt_mode) {
+					run = 0; /* End of the file in batch mode */
+					break;
+				}
+#endif
 				if(Menu()) {
 					run = 0;
 				}
@@ -522,28 +836,87 @@ Loop()
 
 /* Go one line up
    --------------
+   Or more if the key was repeated -- see ForceRep().
 */
 LoopUp()
 {
+	int n, i, len;
+
+	if((n = fe_rep) > 1) {
+		if(n > lp_cur)
+			n = lp_cur;
+
+		/* The column is limited by the lines in between, as if BfEdit()
+		   was on each of them */
+		for(i = 1; i < n; ++i) {
+			if(box_shc > (len = LineLen(PeekLine(lp_cur - i))))
+				box_shc = len;
+		}
+
+		lp_cur -= n;
+
+		if(box_shr >= n)
+			box_shr -= n;
+		else {
+			box_shr = 0;
+			RefreshAll();
+		}
+
+		return;
+	}
+
 	--lp_cur; // FIXME -- check if we are on the 1st line?
 
 	if(box_shr)
 		--box_shr;
-	else
+	else {
+		ScrollBoxDown(0);
 		Refresh(0, lp_cur);
+	}
 }
 
 /* Go one line down
    ----------------
+   Or more if the key was repeated -- see ForceRep().
 */
 LoopDown()
 {
+	int n, i, len;
+
+	if((n = fe_rep) > 1) {
+		/* The lines can be still being read */
+		if(ReadMore(lp_cur + n))
+			ShowFilename();
+
+		if(n > lp_now - 1 - lp_cur)
+			n = lp_now - 1 - lp_cur;
+
+		/* See LoopUp() */
+		for(i = 1; i < n; ++i) {
+			if(box_shc > (len = LineLen(PeekLine(lp_cur + i))))
+				box_shc = len;
+		}
+
+		lp_cur += n;
+
+		if(box_shr + n < box_rows)
+			box_shr += n;
+		else {
+			box_shr = box_rows - 1;
+			RefreshAll();
+		}
+
+		return;
+	}
+
 	++lp_cur; // FIXME -- check if we are on the last line?
 
 	if(box_shr < box_rows - 1)
 		++box_shr;
-	else
+	else {
+		ScrollBoxUp(0);
 		Refresh(0, lp_cur - box_rows + 1);
+	}
 }
 
 /* Go to document top
@@ -569,6 +942,10 @@ LoopBottom()
 {
 	int first, last;
 
+	/* On error, the filename was cleared -- see ReadMore() */
+	if(ReadAll())
+		ShowFilename();
+
 	first = GetFirstLine();
 	last = GetLastLine();
 
@@ -640,7 +1017,10 @@ LoopCr()
 		if(ln_dat[box_shc]) {
 			/* Cursor is in the middle of the line */
 			if((ok = SplitLine(lp_cur, box_shc))) {
-				CrtClearEol();
+				if(!sh_hold)
+					CrtClearEol();
+
+				sh_len[box_shr] = -1;
 			}
 		}
 		else {
@@ -653,7 +1033,10 @@ LoopCr()
 		if((ok = InsertLine(lp_cur, NULL))) {
 			if(ln_dat[0]) {
 				/* Line is not empty */
-				CrtClearEol();
+				if(!sh_hold)
+					CrtClearEol();
+
+				sh_len[box_shr] = -1;
 			}
 			/* else { */
 				/* Line is empty */
@@ -686,7 +1069,7 @@ LoopCr()
 			if(i) {
 				k = i;
 				
-				strcpy(ln_dat + i, lp_arr[lp_cur]);
+				strcpy(ln_dat + i, PeekLine(lp_cur));
 
 				ModifyLine(lp_cur, ln_dat);
 			}
@@ -696,9 +1079,11 @@ LoopCr()
 
 			++box_shr;
 
+			ScrollBoxDown(box_shr);
 			Refresh(box_shr, lp_cur);
 		}
 		else {
+			ScrollBoxUp(0);
 			Refresh(0, lp_cur - box_rows + 1);
 		}
 
@@ -712,38 +1097,44 @@ LoopCr()
 
 /* Set block start
    ---------------
+   The end is kept, unless the start goes after it.
 */
 LoopBlkStart()
 {
-	if(blk_start != -1 || (blk_end != -1 && lp_cur > blk_end)) {
-		LoopBlkUnset();
+	int start, count;
+
+	start = blk_start;
+	count = blk_count;
+
+	if(blk_end != -1 && lp_cur > blk_end) {
+		blk_end = -1;
 	}
 
 	blk_start = lp_cur;
+	blk_count = (blk_end != -1 ? blk_end - blk_start + 1 : 0);
 
-	if(blk_end != -1) {
-		RefreshBlock(box_shr, 1);
-
-		blk_count = blk_end - blk_start + 1;
-	}
+	RefreshBlock(start, count);
 }
 
 /* Set block end
    -------------
+   The start is kept, unless the end goes before it.
 */
 LoopBlkEnd()
 {
-	if(blk_end != -1 || (blk_start != -1 && lp_cur < blk_start) ) {
-		LoopBlkUnset();
+	int start, count;
+
+	start = blk_start;
+	count = blk_count;
+
+	if(blk_start != -1 && lp_cur < blk_start) {
+		blk_start = -1;
 	}
 
 	blk_end = lp_cur;
+	blk_count = (blk_start != -1 ? blk_end - blk_start + 1 : 0);
 
-	if(blk_start != -1) {
-		RefreshBlock(0, 1);  // FIXME -- optimize
-
-		blk_count = blk_end - blk_start + 1;
-	}
+	RefreshBlock(start, count);
 }
 
 /* Unset block
@@ -751,14 +1142,17 @@ LoopBlkEnd()
 */
 LoopBlkUnset()
 {
-	if(blk_count) {
-		if(blk_start <= GetLastLine() && blk_end >= GetFirstLine()) {
-			RefreshBlock(0, 0);  // FIXME -- optimize
-		}
-	}
+	int start, count;
+
+	start = blk_start;
+	count = blk_count;
 
 	blk_start = blk_end = -1;
 	blk_count = 0;
+
+	if(count) {
+		RefreshBlock(start, count);
+	}
 }
 
 LoopBlkEx()
@@ -803,8 +1197,10 @@ LoopCopyEx()
 
 	if((clp_arr = AllocMem(blk_count * SIZEOF_PTR))) {
 		for(i = 0; i < blk_count; ++i) {
-			if((clp_arr[i] = AllocMem(strlen(lp_arr[blk_start + i]) + 1))) {
-				strcpy(clp_arr[i], lp_arr[blk_start + i]);
+			/* Read only, don't swap in the lines of the block. LineAlloc()
+			   can swap out the line, so read it again after it. */
+			if((clp_arr[i] = LineAlloc(LineLen(PeekLine(blk_start + i)), 0))) {
+				strcpy(clp_arr[i], PeekLine(blk_start + i));
 			}
 			else {
 				FreeArray(clp_arr, i, 1);
@@ -825,22 +1221,47 @@ LoopCopyEx()
 
 /* Delete line
    -----------
+   Or more if the key was repeated -- see ForceRep().
 */
 LoopDelete()
 {
 
 #if OPT_BLOCK
 
+	/* The repeats delete the lines that follow, at once; or the
+	   block, and then the lines that follow */
+	if(fe_rep > 1) {
+		if(blk_count) {
+			ForceAgain(K_DELETE, fe_rep - 1);
+		}
+		else {
+			/* The lines can be still being read */
+			if(ReadMore(lp_cur + fe_rep))
+				ShowFilename();
+
+			blk_start = lp_cur;
+
+			if((blk_end = lp_cur + fe_rep - 1) > lp_now - 1)
+				blk_end = lp_now - 1;
+
+			blk_count = blk_end - blk_start + 1;
+		}
+	}
+
 	LoopBlkEx();
 	LoopDeleteEx();
 	
 #else
 
-	if(lp_cur != lp_now - 1) {
-			DeleteLine(lp_cur);
-	}
-	else {
-		ClearLine(lp_cur);
+	int n;
+
+	for(n = fe_rep; n; --n) {
+		if(lp_cur != lp_now - 1) {
+				DeleteLine(lp_cur);
+		}
+		else {
+			ClearLine(lp_cur); break;
+		}
 	}
 
 	Refresh(box_shr, lp_cur);
@@ -857,25 +1278,34 @@ LoopDelete()
 
 LoopDeleteEx()
 {
+	int i;
+
 	//if(blk_count) {
 		LoopGo(blk_start);
 
-		while(blk_count--) {
-			if(blk_start != lp_now - 1) {
-				DeleteLine(blk_start);
-			}
-			else {
-				ClearLine(blk_start);
-			}
+		/* The last line of the document is cleared, not deleted */
+		if(blk_end == lp_now - 1) {
+			ClearLine(blk_end);
+
+			--blk_count;
+		}
 
-			--blk_end;
+		if(blk_count) {
+			DeleteLines(blk_start, blk_count);
 
-			Refresh(box_shr, lp_cur);
+			if(box_shr + blk_count < box_rows) {
+				for(i = 0; i < blk_count; ++i) {
+					ScrollBoxUp(box_shr);
+				}
+			}
 		}
 
+		/* Unselect before the refresh, the lines that follow are not selected */
 		blk_start = blk_end = -1;
 		blk_count = 0;
 
+		Refresh(box_shr, lp_cur);
+
 		box_shc = 0;
 
 		lp_chg = 1;
@@ -916,16 +1346,35 @@ LoopPaste()
 
 #if OPT_BLOCK
 
-	int i;
+	int n, i, k;
 
 	if(clp_count) {
-		for(i = 0; i < clp_count; ++i) {
-			if(InsertLine(lp_cur, clp_arr[i])) {
-				Refresh(box_shr, lp_cur);
-				LoopDown();
+		/* Paste the clipboard again if the key was repeated -- see ForceRep() */
+		n = 0;
+
+		for(i = fe_rep; i; --i) {
+			n += (k = InsertLines(lp_cur + n, clp_arr, clp_count));
+
+			if(k != clp_count)
+				break;
+		}
+
+		if(n) {
+			lp_cur += n;
+
+			if(box_shr + n < box_rows) {
+				for(i = 0; i < n; ++i) {
+					ScrollBoxDown(box_shr);
+				}
+
+				Refresh(box_shr, lp_cur - n);
+
+				box_shr += n;
 			}
 			else {
-				break;
+				box_shr = box_rows - 1;
+
+				RefreshAll();
 			}
 		}
 
@@ -936,14 +1385,17 @@ LoopPaste()
 
 #else
 
-	if((InsertLine(lp_cur, clp_line))) {
+	int i;
+
+	for(i = fe_rep; i && InsertLine(lp_cur, clp_line); --i) {
+		ScrollBoxDown(box_shr);
 		Refresh(box_shr, lp_cur);
-		LoopDown();
+
+		fe_rep = 1; LoopDown();
 
 		box_shc = 0;
 
 		lp_chg = 1;
-
 	}
 
 #endif
@@ -983,12 +1435,12 @@ LoopLeftDel()
 	if(ln_dat[0]) {
 		/* Line is not empty */
 		
-		p = lp_arr[lp_cur - 1];
+		p = PeekLine(lp_cur - 1);
 
 		if(*p) {
 			/* Previous line is not empty */
 			
-			pos = strlen(p);
+			pos = LineLen(p);
 
 			if((ok = JoinLines(lp_cur - 1))) {
 				rs = 0;
@@ -1020,6 +1472,7 @@ LoopLeftDel()
 
 			--box_shr;
 
+			ScrollBoxUp(box_shr + 1);
 			Refresh(box_shr + rs, lp_cur + rs);
 		}
 		else {
@@ -1040,7 +1493,7 @@ LoopRightDel()
 	char *p;
 	int ok, rs;
 	
-	p = lp_arr[lp_cur + 1];
+	p = PeekLine(lp_cur + 1);
 
 	if(ln_dat[0]) {
 		/* Line is not empty */
@@ -1079,6 +1532,8 @@ LoopRightDel()
 	}
 
 	if(ok) {
+		ScrollBoxUp(box_shr + 1);
+
 		if(box_shr + rs < box_rows) {
 			Refresh(box_shr + rs, lp_cur + rs);
 		}
@@ -1101,9 +1556,13 @@ LoopFind()
 	col  = box_shc;
 	flen = strlen(find_str);
 
+	/* On error, the filename was cleared -- see ReadMore() */
+	if(ReadAll())
+		ShowFilename();
+
 	for(line = lp_cur; line < lp_now; ++line)
 	{
-		for(slen = strlen((p = lp_arr[line])); flen <= (slen - col) && col < slen; ++col)
+		for(slen = LineLen((p = PeekLine(line))); flen <= (slen - col) && col < slen; ++col)
 		{
 			for(i = 0; i < flen && find_str[i] == p[col + i]; ++i)
 				;
@@ -1155,7 +1614,7 @@ LoopFindNext()
 		old_box_shc = box_shc;
 
 		/* Skip current character */
-		if(box_shc < strlen(lp_arr[lp_cur]))
+		if(box_shc < LineLen(PeekLine(lp_cur)))
 			++box_shc;
 
 		/* Set old cursor position on find failure */
@@ -1174,7 +1633,7 @@ LoopFindNext()
 LoopGoLine()
 {
 	char buf[6];
-	int line, first, last;
+	int line;
 
 	buf[0] = '\0';
 
@@ -1182,21 +1641,10 @@ LoopGoLine()
 	{
 		line = atoi(buf);
 
+		ReadMore(line - 1);
+
 		if(line > 0 && line <= lp_now)
 		{
-			/*
-			first = GetFirstLine();
-			last = GetLastLine();
-
-			lp_cur = line - 1;
-			box_shc = 0;
-
-			if(lp_cur >= first && lp_cur <= last)
-				box_shr = lp_cur - first;
-			else
-				Refresh((box_shr = 0), lp_cur);
-			*/
-
 			LoopGo(line - 1);
 		}
 	}
@@ -1248,10 +1696,9 @@ LoopMacro()
 			}
 		}
 	
-		MacroRunFile(fn, 0);
+		MacroRunFile(fn);
 	}
 }
 
 #endif
 
-
\ No newline at end of file
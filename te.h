@@ -66,6 +66,25 @@
 	25 Sep 2021 : v1.71
 	01 Nov 2021 : v1.72
 	20 Nov 2021 : v1.73
+	17 Oct 2026 : Added LA_GRAN, LA_CLASSES, LA_CHUNK.
+	17 Oct 2026 : Added LA_SLACK.
+	17 Oct 2026 : Added LP_CHUNK, LP_LIMIT.
+	17 Oct 2026 : Added OPT_SWAP, LA_SWAPPED, SW_FCBNAME, SW_GRAN, SW_BATCH.
+	17 Oct 2026 : Added RD_BUF_SIZ, CPM_EOF.
+	17 Oct 2026 : Added RD_SLICE.
+	17 Oct 2026 : Added SH_GAP.
+	17 Oct 2026 : Added CRT_OUT_BUF, CRT_OUT_SIZ.
+	17 Oct 2026 : Added CRT_CAN_INS.
+	17 Oct 2026 : Added PS_F_CLP, PS_F_LIN_CUR, PS_F_LIN_NOW, PS_F_LIN_MAX, PS_F_COL_CUR, PS_F_COL_NOW, PS_FIELDS.
+	17 Oct 2026 : Added CRT_LOC_COST, CRT_NL_COST. Removed SH_GAP.
+	17 Oct 2026 : Added OPT_STATS, ST_OUT, ST_LOC, ST_ROW, ST_MEM, ST_MAX.
+	17 Oct 2026 : Added OPT_TRACE, TR_RECORD, TR_PLAY.
+	17 Oct 2026 : Added CRT_RESIZE, RS_MIN_ROWS, RS_MIN_COLS.
+	17 Oct 2026 : Added MAC_CACHE, MC_... commands of compiled macros.
+	17 Oct 2026 : Added FORCED_REP, MAC_REP_MAX.
+	17 Oct 2026 : Added OPT_BATCH.
+	17 Oct 2026 : OPT_SWAP is 0 by default.
+	17 Oct 2026 : Added MoveTo.
 
 	Notes:
 
@@ -93,9 +112,21 @@
 #define CRT_DEF_COLS 80 /* Default screen columns */
 #endif
 
+#ifndef OPT_STATS
+#define OPT_STATS  0  /* Count the work done for each key -- see te_ui.c */
+#endif
+
+#ifndef OPT_TRACE
+#define OPT_TRACE  0  /* Record and play back key traces -- see te_trace.c */
+#endif
+
 #ifndef OPT_Z80
+#if OPT_STATS
+#define OPT_Z80    0  /* The statistics need the C versions of putstr(), etc. */
+#else
 #define OPT_Z80    1  /* Write some things as Z80 assembler */
 #endif
+#endif
 
 #ifndef OPT_LWORD
 #define OPT_LWORD  1  /* Go to word on the left */
@@ -121,6 +152,18 @@
 #define OPT_MACRO  1  /* Enable macros */
 #endif
 
+#ifndef OPT_SWAP
+#define OPT_SWAP   0  /* Swap text lines to disk when memory is low */
+#endif
+
+#ifndef OPT_BATCH
+#if OPT_MACRO
+#define OPT_BATCH  1  /* Apply a macro to files, without CRT -- see te_batch.c */
+#else
+#define OPT_BATCH  0  /* The batch mode needs the macros */
+#endif
+#endif
+
 /* CRT defs.
    ---------
 */
@@ -128,6 +171,30 @@
 #define CRT_CAN_REV 1
 #endif
 
+#ifndef CRT_LOC_COST
+#define CRT_LOC_COST 4   /* # of characters sent by CrtLocate() -- see Locate() in te_ui.c */
+#endif
+
+#ifndef CRT_NL_COST
+#define CRT_NL_COST 2    /* # of characters sent by CrtOut('\n') */
+#endif
+
+#ifndef CRT_CAN_INS
+#define CRT_CAN_INS 0    /* Insert and delete lines with CrtInsLine(), CrtDelLine() -- see te_ui.c */
+#endif
+
+#ifndef CRT_OUT_BUF
+#define CRT_OUT_BUF 0    /* Buffer the output, and write it with CrtWrite() -- see te_ui.c */
+#endif
+
+#ifndef CRT_OUT_SIZ
+#define CRT_OUT_SIZ 128  /* Output buffer size */
+#endif
+
+#ifndef CRT_RESIZE
+#define CRT_RESIZE 0     /* The screen can be resized while running -- see SetScreenSize() in te_ui.c */
+#endif
+
 #ifndef CRT_LONG
 #define CRT_LONG 1
 #endif
@@ -146,9 +213,47 @@
    ----------
 */
 #define FORCED_MAX 128   /* Keyboard forced entry buffer size (for paste, tabs, etc.) */
+#define FORCED_REP 2000  /* Forced entry code: the next one is the # of repeats of the key after it */
 
 #define FIND_MAX   32    /* Find string buffer size */
 
+#define RS_MIN_ROWS 8    /* Min. screen size on resize, as in TECF */
+#define RS_MIN_COLS 51
+
+#define RD_BUF_SIZ 512   /* Read file buffer size, must be > max. line width + CR + LF */
+
+#ifndef RD_SLICE
+#define RD_SLICE   16    /* Read file: # of lines to read at a time, while the file is being read */
+#endif
+
+#define CPM_EOF    0x1A  /* End of file character in CP/M text files */
+
+#ifndef LA_GRAN
+#define LA_GRAN    4     /* Line storage: size classes are multiple of this # of bytes, >= 2 + SIZEOF_PTR */
+#endif
+
+#define LA_CLASSES (256 / LA_GRAN + 2)  /* Line storage: # of size classes */
+
+#define LA_SLACK   8     /* Line storage: room to grow for edited lines, in characters */
+
+#ifndef LA_CHUNK
+#define LA_CHUNK   1024  /* Line storage: bytes to get from malloc() each time */
+#endif
+
+#define LA_SWAPPED 0x80  /* Line storage: flag in the size class, the line has a copy in the swap file */
+
+#ifndef LP_CHUNK
+#define LP_CHUNK   128   /* Lines array: # of lines to grow each time it is full */
+#endif
+
+#ifndef LP_LIMIT
+#define LP_LIMIT   9999  /* Lines array: max. # of lines -- see PS_TXT */
+#endif
+
+#define SW_FCBNAME "TE      $$$"  /* Swap file: name in FCB format */
+#define SW_GRAN    16    /* Swap file: lines are written in units of this # of bytes, must divide 128 */
+#define SW_BATCH   16    /* Swap file: max. # of lines to swap out each time */
+
 #define PS_ROW     0     /* Information position */
 #define PS_FNAME   4     /* Filename - position in row */
 #define PS_TXT     "--- | Lin:0000/0000/0000 Col:00/00 Len:00"  /* Information layout */
@@ -156,19 +261,46 @@
 #define PS_CLP     (cf_cols - 41)  /* Clipboard status */
 #define PS_LIN_CUR (cf_cols - 31)  /* Current line # - position in row */
 #define PS_LIN_NOW (cf_cols - 26)  /* How many lines # - position in row */
-#define PS_LIN_MAX (cf_cols - 21)  /* Max. # of lines - position in row */
+#define PS_LIN_MAX (cf_cols - 21)  /* Size of lines array - position in row */
 #define PS_COL_CUR (cf_cols - 12)  /* Current column # - position in row */
 #define PS_COL_NOW (cf_cols -  2)  /* Line length - position in row */
 #define PS_COL_MAX (cf_cols -  9)  /* Max. line length - position in row */
 
+#define PS_F_CLP     0  /* Information fields -- see ShowField() */
+#define PS_F_LIN_CUR 1
+#define PS_F_LIN_NOW 2
+#define PS_F_LIN_MAX 3
+#define PS_F_COL_CUR 4
+#define PS_F_COL_NOW 5
+#define PS_FIELDS    6  /* # of information fields */
+
+#define ST_OUT     0     /* Statistics: characters printed -- see StatKey() */
+#define ST_LOC     1     /* Statistics: calls to CrtLocate() from Locate() */
+#define ST_ROW     2     /* Statistics: rows of the editor box printed */
+#define ST_MEM     3     /* Statistics: calls to AllocMem(), LineAlloc(), LineFree() */
+#define ST_MAX     4     /* Statistics: # of counters */
+
+#define TR_RECORD  1     /* Trace mode: record the keys -- see te_trace.c */
+#define TR_PLAY    2     /* Trace mode: play the keys back */
+
 #if CRT_LONG
 #define BOX_ROW    2        /* Editor box position */
 #else
 #define BOX_ROW    1
 #endif
 
+#if OPT_TRACE
+#define getchr     TraceKey /* Get a character from the keyboard, or the trace file */
+#else
 #define getchr     GetKey   /* Get a character from the keyboard */
-#define putchr     CrtOut   /* Print a character on screen */
+#endif
+#if OPT_STATS
+#define putchr     StatOut  /* Print a character on screen, and count it */
+#define MoveTo     StatLoc  /* Move the cursor, and count it */
+#else
+#define putchr     CrtOut    /* Print a character on screen */
+#define MoveTo     CrtLocate /* Move the cursor */
+#endif
 
 #if OPT_MACRO
 
@@ -182,7 +314,15 @@
 #define MAC_SYM_MAX 10   /* Max. length of macro symbol name in characters */
 #define MAC_SYM_SIZ 11   /* MAC_SYM_MAX + '\0' */
 #define MAC_FTYPE   ".m" /* Default filetype for macro files */
+#define MAC_CACHE   4    /* Max. # of compiled macros in memory */
+#define MAC_REP_MAX 9999 /* Max. # of repeats of a key in macros */
+
+#define MC_END      0    /* Commands of compiled macros -- see te_macro.c */
+#define MC_TEXT     1
+#define MC_KEY      2
+#define MC_FILE     3
+#define MC_INDENT   4
+#define MC_LIST     5
 
 #endif
 
-
\ No newline at end of file
@@ -40,6 +40,10 @@
 	06 Jul 2021 : Optimize CrtOut().
 	17 Jun 2023 : Add some delay in CrtInSt() to make real hardware happy.
 	18 Jun 2023 : Add input translations for PgUp and PgDn. Add alternate input translations for Begin and End (VT100).
+	17 Oct 2026 : Added CrtInsLine(), CrtDelLine().
+	17 Oct 2026 : Added CrtStat().
+	17 Oct 2026 : Set CRT_LOC_COST.
+	17 Oct 2026 : Buffered output. Added CrtWrite(), removed CrtOut().
 
 	Notes:
 
@@ -65,6 +69,13 @@
 #define OPT_BLOCK 1  /* Block selection */
 #define OPT_MACRO 1  /* Enable macros */
 
+/* Definitions
+   -----------
+*/
+#define CRT_CAN_INS 1    /* Insert and delete lines are available */
+#define CRT_LOC_COST 7   /* ESC [ row ; col H */
+#define CRT_OUT_BUF 1    /* Buffered output -- see CrtWrite() */
+
 /* Include main code
    -----------------
 */
@@ -103,23 +114,51 @@ CrtReset()
 {
 }
 
-/* Output character to the CRT
-   ---------------------------
-   All program output is done with this function.
+/* Write the output buffer
+   -----------------------
+   All program output is done with this function -- see CrtOut() in te_ui.c.
 
    On '\n' outputs '\n' + '\r'.
 
-   void CrtOut(int ch)
+   void CrtWrite(char *buf, int len)
 */
 #asm
-CrtOut:
-	ld   c,l
-	ld   a,l
+CrtWrite:
+	pop  bc
+	pop  de
+	pop  hl
+	push hl
+	push de
+	push bc
+
+CrtWrite1:
+	ld   a,d
+	or   e
+	ret  z
+
+	dec  de
+
+	ld   c,(hl)
+	inc  hl
+
+	push de
+	push hl
+
+	ld   a,c
 	cp   10
-	jp   nz,BiosConout
+	jr   nz,CrtWrite2
+
 	call BiosConout
+
 	ld   c,13
-	jp   BiosConout
+
+CrtWrite2:
+	call BiosConout
+
+	pop  hl
+	pop  de
+
+	jr   CrtWrite1
 #endasm
 
 /* Input character from the keyboard
@@ -229,6 +268,21 @@ CrtInEx:
 	ret
 #endasm
 
+/* Check if there is a key waiting
+   -------------------------------
+   Return NZ if there is a key, else Z. Used to skip screen updates while
+   the user is typing ahead.
+
+   int CrtStat(void)
+*/
+#asm
+CrtStat:
+	call BiosConst
+	ld h,0
+	ld l,a
+	ret
+#endasm
+
 /* Clear screen and send cursor to 0,0
    -----------------------------------
    void CrtClear(void)
@@ -278,4 +332,24 @@ int on;
 	CrtOut(27); CrtOut('['); CrtOut(on ? '7' : '0'); CrtOut('m');
 }
 
+/* Insert a blank line, the following lines go down
+   -------------------------------------------------
+*/
+CrtInsLine(row)
+int row;
+{
+	CrtLocate(row, 0);
+	CrtOut(27); CrtOut('['); CrtOut('L');
+}
+
+/* Delete a line, the following lines go up
+   ----------------------------------------
+*/
+CrtDelLine(row)
+int row;
+{
+	CrtLocate(row, 0);
+	CrtOut(27); CrtOut('['); CrtOut('M');
+}
+
 
\ No newline at end of file
@@ -33,6 +33,7 @@
 	Changes:
 
 	14 Oct 2021 : 1st version.
+	17 Oct 2026 : Added CrtStat().
 
 	Notes:
 
@@ -144,6 +145,21 @@ CrtInEx:
 	ret
 #endasm
 
+/* Check if there is a key waiting
+   -------------------------------
+   Return NZ if there is a key, else Z. Used to skip screen updates while
+   the user is typing ahead.
+
+   int CrtStat(void)
+*/
+#asm
+CrtStat:
+	call BiosConst
+	ld h,0
+	ld l,a
+	ret
+#endasm
+
 /* Clear screen and send cursor to 0,0
    -----------------------------------
    void CrtClear(void)
@@ -0,0 +1,167 @@
+/*	te_batch.c
+
+	Text editor.
+
+	Batch mode.
+
+	Copyright (c) 2015-2026 Miguel Garcia / FloppySoftware
+
+	This program is free software; you can redistribute it and/or modify it
+	under the terms of the GNU General Public License as published by the
+	Free Software Foundation; either version 2, or (at your option) any
+	later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+	Changes:
+
+	17 Oct 2026 : Added BatchArgs(), BatchRun(), BatchFile(), BatchErr(), BatchPuts().
+	17 Oct 2026 : Added BatchWarn(). Read all the file before running the macro.
+
+	Notes:
+
+	With OPT_BATCH, the command line can be:
+
+	te -m macro file... : apply the macro to each file, and save the ones that changed.
+
+	There is no CRT in this mode: it's not set up, and the screen is held
+	the whole time, so nothing is printed -- see sh_hold and SysLine(). There is no
+	keyboard either: GetKey() returns ESC, that ends the editing of each
+	file -- see Loop().
+
+	The errors are printed with the BDOS, after the name of the file, and
+	the file is not saved. The exit code is 1 if there were errors, else 0,
+	for scripts. The notices, as the TABs changed to spaces while reading,
+	are printed the same way, but they are not errors.
+
+	The whole file is read before running the macro, so the notices and
+	errors of the reading are known before saving it.
+*/
+
+/* Check the command line for the batch option
+   -------------------------------------------
+   Return NZ if 'opt' is the batch option, else Z.
+*/
+BatchArgs(opt)
+char *opt;
+{
+	return *opt == '-' && toupper(opt[1]) == 'M' && !opt[2];
+}
+
+/* Run the batch mode
+   ------------------
+   Returns 1 if there were errors, else 0.
+*/
+BatchRun(argc, argv)
+#ifdef OS_POSIX
+int argc; char *argv[];
+#else
+int argc, argv[];
+#endif
+{
+	int i;
+
+	if(argc < 4) {
+		BatchErr("Bad command line. Use: te -m macro file...");
+
+		return 1;
+	}
+
+	/* Print nothing */
+	sh_hold = 1;
+
+	/* Compile the macro once -- see MacroRunFile() */
+	bt_name = argv[2];
+
+	if(MacroLoad(argv[2]) != -1) {
+		for(i = 3; i < argc; ++i) {
+			BatchFile(argv[2], argv[i]);
+		}
+	}
+
+#if OPT_SWAP
+
+	/* Remove the swap file */
+	SwapClose();
+
+#endif
+
+	return bt_errs != 0;
+}
+
+/* Apply the macro to a file
+   -------------------------
+*/
+BatchFile(mac, fn)
+char *mac, *fn;
+{
+	int errs;
+
+	bt_name = fn; errs = bt_errs;
+
+	if(strlen(fn) > FILENAME_MAX - 1) {
+		BatchErr("Filename too long"); return;
+	}
+
+	if(ReadFile(fn) || ReadAll() || MacroRunFile(mac)) {
+		return;
+	}
+
+	strcpy(file_name, fn);
+
+	/* Each file starts with an empty clipboard */
+	LoopClrClp();
+
+	/* Run the macro, until it ends and GetKey() returns ESC */
+	Loop();
+
+	/* Don't save the file on errors */
+	if(bt_errs == errs && lp_chg && !WriteFile(fn)) {
+		BatchPuts(fn); BatchPuts(": saved\r\n");
+	}
+}
+
+/* Print error message
+   -------------------
+   It's ErrLine() in batch mode.
+*/
+BatchErr(s)
+char *s;
+{
+	BatchWarn(s);
+
+	++bt_errs;
+}
+
+/* Print notice message
+   --------------------
+   It's WarnLine() in batch mode. It's not an error.
+*/
+BatchWarn(s)
+char *s;
+{
+	if(bt_name) {
+		BatchPuts(bt_name); BatchPuts(": ");
+	}
+
+	BatchPuts(s); BatchPuts("\r\n");
+}
+
+/* Print string with the BDOS
+   --------------------------
+*/
+BatchPuts(s)
+char *s;
+{
+	while(*s) {
+		bdos_a(0x02, *s++);
+	}
+}
+
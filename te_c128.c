@@ -32,6 +32,8 @@
 	Changes:
 
 	11 Nov 2021 : 1st version.
+	17 Oct 2026 : Added CrtInsLine(), CrtDelLine().
+	17 Oct 2026 : Added CrtStat().
 
 	Notes:
 
@@ -56,6 +58,11 @@
 #define OPT_BLOCK 1  /* Block selection */
 #define OPT_MACRO 1  /* Enable macros */
 
+/* Definitions
+   -----------
+*/
+#define CRT_CAN_INS 1    /* Insert and delete lines are available */
+
 /* Include main code
    -----------------
 */
@@ -127,6 +134,21 @@ CrtIn:
 	ret
 #endasm
 
+/* Check if there is a key waiting
+   -------------------------------
+   Return NZ if there is a key, else Z. Used to skip screen updates while
+   the user is typing ahead.
+
+   int CrtStat(void)
+*/
+#asm
+CrtStat:
+	call BiosConst
+	ld h,0
+	ld l,a
+	ret
+#endasm
+
 /* Clear screen and send cursor to 0,0
    -----------------------------------
    void CrtClear(void)
@@ -173,4 +195,24 @@ int on;
 	CrtOut(27); CrtOut('G'); CrtOut(on ? '4' : '0');
 }
 
+/* Insert a blank line, the following lines go down
+   -------------------------------------------------
+*/
+CrtInsLine(row)
+int row;
+{
+	CrtLocate(row, 0);
+	CrtOut(27); CrtOut('E');
+}
+
+/* Delete a line, the following lines go up
+   ----------------------------------------
+*/
+CrtDelLine(row)
+int row;
+{
+	CrtLocate(row, 0);
+	CrtOut(27); CrtOut('R');
+}
+
 
\ No newline at end of file
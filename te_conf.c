@@ -27,6 +27,7 @@
 	04 Apr 2021 : Added key bindings.
 	06 Apr 2021 : Added screen characters for various purposes.
 	11 May 2021 : Default values.
+	17 Oct 2026 : The POSIX adaptation defines the configuration variables in C.
 
 	Notes:
 
@@ -61,11 +62,13 @@ extern unsigned int cf_start;
 extern unsigned char cf_version;
 extern int cf_bytes;
 
+#ifndef OS_POSIX
+
 #asm
 cf_start:
 	          defb 'TE_CONF', 0     ;  8 bytes > Identifier + ZERO for the configuration block in memory and COM file.
 
-cf_version:   defb 2                ;  1 byte  > Configuration version >= 0. It's not the TE version.
+cf_version:   defb 2                ;  1 byte  > Configuration version >= 0. It is not the TE version.
 
 cf_name:      defb 0,0,0,0,0,0,0,0  ; 32 bytes > Configuration name + ZERO.
               defb 0,0,0,0,0,0,0,0
@@ -75,7 +78,7 @@ cf_name:      defb 0,0,0,0,0,0,0,0  ; 32 bytes > Configuration name + ZERO.
 cf_rows:      defb 25               ;  1 byte  > Screen rows or 0 for auto.
 cf_cols:      defb 80               ;  1 byte  > Screen columns or 0 for auto.
 
-cf_mx_lines:  defw 512              ;  2 bytes > Max. number of lines in editor.
+cf_mx_lines:  defw 512              ;  2 bytes > Initial size of lines array.
                                     ;            Each line takes 2 bytes (1 word) of memory.
 
 cf_tab_cols:  defb 4                ;  1 byte  > How many spaces a tabulation inserts.
@@ -115,4 +118,5 @@ cf_bytes:     defw $ - cf_start + 2 ;  2 bytes > Block configuration size in byt
 
 #endasm
 
-
\ No newline at end of file
+#endif
+
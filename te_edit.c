@@ -38,6 +38,19 @@
 	01 Mar 2020 : Added CLANG support. Set fe_forced flag in ForceGetCh().
 	04 Jan 2021 : Use configuration variables.
 	25 Sep 2021 : Ignore '\0' characters comming from macro comments. Use editln variable.
+	17 Oct 2026 : Use GetLine().
+	17 Oct 2026 : Use LineLen().
+	17 Oct 2026 : Call LineSetLen() after modifying the line in place.
+	17 Oct 2026 : Tell the shadow screen when the line was printed.
+	17 Oct 2026 : Refresh the rows left for later when the keyboard is idle.
+	17 Oct 2026 : Use ShowField().
+	17 Oct 2026 : Use Locate(), LocateAt().
+	17 Oct 2026 : Call StatKey() before each key.
+	17 Oct 2026 : Print nothing while sh_hold is set.
+	17 Oct 2026 : Added ForceRep(), ForceAgain(), ForceFront(), ForcePop(), ForceCanRep(). Do the repeats
+	              of a key at once. K_TAB inserts the spaces at once.
+	17 Oct 2026 : Let GetKey() read the file while waiting for a key.
+	17 Oct 2026 : ForceAgain() shows an error if the repeats are lost.
 */
 
 /* Edit current line
@@ -46,17 +59,17 @@
 */
 BfEdit()
 {
-	int i, ch, len, run, upd_lin, upd_col, upd_now, upd_cur, spc, old_len;
+	int i, k, ch, len, run, upd_lin, upd_col, upd_now, upd_cur, spc, old_len;
 	char *buf;
 	
 	/* Tell we are editing */
 	editln = 1;
 
 	/* Get current line contents */
-	strcpy(ln_dat, lp_arr[lp_cur]);
+	strcpy(ln_dat, (buf = PeekLine(lp_cur)));
 
 	/* Setup some things */
-	len = old_len = strlen(ln_dat);
+	len = old_len = LineLen(buf);
 
 	run = upd_col = upd_now = upd_cur = 1; upd_lin = spc = 0;
 
@@ -67,18 +80,25 @@ BfEdit()
 	/* Loop */
 	while(run)
 	{
-		/* Print line? */
+		/* Print line? Not while a macro runs -- see RefreshScreen() */
+		if(upd_lin && sh_hold)
+		{
+			upd_lin = spc = 0;
+		}
+
 		if(upd_lin)
 		{
 			upd_lin = 0;
 
 			putstr(ln_dat + box_shc);
 
-			/* Print a space? */
-			if(spc)
-			{
-				putchr(' '); spc = 0;
-			}
+			/* Print spaces over the deleted characters */
+			putchrx(' ', spc);
+
+			/* The cursor is at the end of the line -- see Locate() */
+			LocateAt(BOX_ROW + box_shr, cf_num + len + spc);
+
+			spc = 0;
 		}
 
 		/* Print length? */
@@ -86,7 +106,7 @@ BfEdit()
 		{
 			upd_now = 0;
 
-			CrtLocate(PS_ROW, PS_COL_NOW); putint("%02d", len);
+			ShowField(PS_F_COL_NOW, PS_COL_NOW, 2, len);
 		}
 
 		/* Print column #? */
@@ -94,7 +114,17 @@ BfEdit()
 		{
 			upd_col = 0;
 
-			CrtLocate(PS_ROW, PS_COL_CUR); putint("%02d", box_shc + 1);
+			ShowField(PS_F_COL_CUR, PS_COL_CUR, 2, box_shc + 1);
+		}
+
+		/* Refresh the rows left for later, if there are no keys waiting -- see Refresh() */
+		if(sh_defer && !CrtStat())
+		{
+			sh_defer = 0;
+
+			RefreshAll();
+
+			upd_cur = 1;
 		}
 
 		/* Locate cursor? */
@@ -102,10 +132,16 @@ BfEdit()
 		{
 			upd_cur = 0;
 
-			CrtLocate(BOX_ROW + box_shr, box_shc + cf_num);
+			Locate(BOX_ROW + box_shr, box_shc + cf_num);
 		}
 
 		/* Get character and do action */
+#if OPT_STATS
+		StatKey();
+#endif
+		/* The file can be read while waiting -- see GetKey() */
+		rd_idle = 1;
+
 #if OPT_MACRO
 		while((ch = ForceGetCh()) == 0)
 			;
@@ -113,6 +149,8 @@ BfEdit()
 		ch = ForceGetCh();
 #endif
 
+		rd_idle = 0;
+
 #if OPT_BLOCK
 
 		/* Unselect block if needed: don't check blk_count, we want to unselect start and / or end block selection */
@@ -137,7 +175,7 @@ BfEdit()
 			if(upd_cur) {
 				LoopBlkUnset();
 
-				CrtLocate(BOX_ROW + box_shr, box_shc + cf_num);
+				Locate(BOX_ROW + box_shr, box_shc + cf_num);
 
 				upd_cur = 0;
 			}
@@ -149,7 +187,10 @@ BfEdit()
 		{
 			if(len < ln_max)
 			{
-				putchr(ch);
+				if(!sh_hold)
+				{
+					putchr(ch);
+				}
 
 				for(i = len; i > box_shc; --i)
 				{
@@ -188,16 +229,26 @@ BfEdit()
 			   keys for Loop(), to avoid wasted time. */
 			switch(ch)
 			{
+				/* The repeats of a key are done at once in the line, and the
+				   rest of them, if any, are put back -- see ForceAgain() */
+
 				case K_LEFT :    /* Move one character to the left -------- */
 					if(box_shc)
 					{
-						--box_shc; ++upd_col;
+						if((i = fe_rep) > box_shc)
+							i = box_shc;
+
+						box_shc -= i; ++upd_col;
+
+						ForceAgain(K_LEFT, fe_rep - i);
 					}
 					else if(lp_cur)
 					{
-						box_shc = 9999 /* strlen(lp_arr[lp_cur - 1]) */ ;
+						box_shc = 9999 /* LineLen(GetLine(lp_cur - 1)) */ ;
+
+						ForceAgain(K_LEFT, fe_rep - 1);
 
-						ch = K_UP;
+						ch = K_UP; fe_rep = 1;
 
 						run = 0;
 					}
@@ -206,11 +257,18 @@ BfEdit()
 				case K_RIGHT :   /* Move one character to the right ------- */
 					if(box_shc < len)
 					{
-						++box_shc; ++upd_col;
+						if((i = fe_rep) > len - box_shc)
+							i = len - box_shc;
+
+						box_shc += i; ++upd_col;
+
+						ForceAgain(K_RIGHT, fe_rep - i);
 					}
 					else if(lp_cur < lp_now - 1)
 					{
-						ch = K_DOWN;
+						ForceAgain(K_RIGHT, fe_rep - 1);
+
+						ch = K_DOWN; fe_rep = 1;
 
 						box_shc = run = 0;
 					}
@@ -219,25 +277,46 @@ BfEdit()
 				case K_LDEL :   /* Delete one character to the left ------- */
 					if(box_shc)
 					{
-						strcpy(ln_dat + box_shc - 1, ln_dat + box_shc);
+						if((i = fe_rep) > box_shc)
+							i = box_shc;
 
-						--box_shc; --len; ++upd_now; ++upd_lin; ++spc; ++upd_col;
+						strcpy(ln_dat + box_shc - i, ln_dat + box_shc);
 
-						putchr('\b');
+						box_shc -= i; len -= i; spc += i; ++upd_now; ++upd_lin; ++upd_col;
+
+						if(!sh_hold)
+						{
+							putchrx('\b', i);
+						}
+
+						ForceAgain(K_LDEL, fe_rep - i);
 					}
 					else if(lp_cur)
+					{
+						ForceAgain(K_LDEL, fe_rep - 1);
+
 						run = 0;
+					}
 					++upd_cur;
 					break;
 				case K_RDEL :   /* Delete one character to the right ----- */
 					if(box_shc < len)
 					{
-						strcpy(ln_dat + box_shc, ln_dat + box_shc + 1);
+						if((i = fe_rep) > len - box_shc)
+							i = len - box_shc;
 
-						--len; ++upd_now; ++upd_lin; ++spc;
+						strcpy(ln_dat + box_shc, ln_dat + box_shc + i);
+
+						len -= i; spc += i; ++upd_now; ++upd_lin;
+
+						ForceAgain(K_RDEL, fe_rep - i);
 					}
 					else if(lp_cur < lp_now -1)
+					{
+						ForceAgain(K_RDEL, fe_rep - 1);
+
 						run = 0;
+					}
 					++upd_cur;
 					break;
 				case K_UP :     /* Up one line --------------------------- */
@@ -303,11 +382,33 @@ BfEdit()
 				case K_TAB :    /* Insert TAB (spaces) ------------------- */
 					i = cf_tab_cols - box_shc % cf_tab_cols;
 
-					while(i--)
+					/* Up to the next tab stops, if repeated */
+					while(--fe_rep && i < ln_max - len)
+						i += cf_tab_cols;
+
+					if(i > ln_max - len)
+						i = ln_max - len;
+
+					if(i > 0)
 					{
-						if(ForceCh(' '))
-							break;
+						if(!sh_hold)
+						{
+							putchrx(' ', i);
+						}
+
+						for(k = len; k >= box_shc; --k)
+						{
+							ln_dat[k + i] = ln_dat[k];
+						}
+
+						for(k = 0; k < i; ++k)
+						{
+							ln_dat[box_shc++] = ' ';
+						}
+
+						len += i; ++upd_lin; ++upd_now; ++upd_col;
 					}
+					++upd_cur;
 					break;
 #if OPT_LWORD
 				case K_LWORD :  /* Move one word to the left ------------ */
@@ -376,13 +477,19 @@ BfEdit()
 	if(len == old_len)
 	{
 		/* Check for changes */
-		if(memcmp(lp_arr[lp_cur], ln_dat, len))
+		if(memcmp(PeekLine(lp_cur), ln_dat, len))
 		{
-			/* Update the changes */
-			strcpy(lp_arr[lp_cur], ln_dat);
+			/* Update the changes, if the line can be read back from the swap file */
+			if((buf = GetLine(lp_cur)))
+			{
+				LineSetLen(strcpy(buf, ln_dat), len);
+
+				/* Changes are not saved */
+				lp_chg = 1;
+			}
 
-			/* Changes are not saved */
-			lp_chg = 1;
+			/* The row was printed here -- see RefreshRow() */
+			sh_len[box_shr] = -1;
 		}
 	}
 	else {
@@ -390,11 +497,17 @@ BfEdit()
 
 		/* Changes are not saved */
 		lp_chg = 1;
+
+		/* The row was printed here -- see RefreshRow() */
+		sh_len[box_shr] = -1;
 	}
 	
 	/* Tell we are not editing */
 	editln = 0;
 
+	/* Other functions move the cursor on their own -- see Locate() */
+	cr_row = -1;
+
 	/* Return last character entered */
 	return ch;
 }
@@ -438,21 +551,125 @@ char *s;
 	return 0;
 }
 
+/* Add a key and its # of repeats to forced entry buffer
+   ------------------------------------------------------
+   The key is returned once, and fe_rep is set to 'n' -- see ForceGetCh().
+   Return Z on success, NZ on failure.
+*/
+ForceRep(ch, n)
+int ch, n;
+{
+	if(fe_now + 3 > FORCED_MAX)
+		return -1;
+
+	ForceCh(FORCED_REP); ForceCh(n); ForceCh(ch);
+
+	return 0;
+}
+
+/* Put a key and its # of repeats back in forced entry buffer
+   ----------------------------------------------------------
+   They are the first ones to be returned. Used for the repeats that were
+   not done by the last key. Does nothing if 'n' is Z. Shows an error if
+   there is no room, and the repeats are lost.
+*/
+ForceAgain(ch, n)
+int ch, n;
+{
+	if(n > 0)
+	{
+		if(fe_now + (n > 1 ? 3 : 1) > FORCED_MAX)
+		{
+			ErrLineForced(); return;
+		}
+
+		ForceFront(ch);
+
+		if(n > 1)
+		{
+			ForceFront(n); ForceFront(FORCED_REP);
+		}
+	}
+}
+
+/* Add a character before the others in forced entry buffer
+   --------------------------------------------------------
+*/
+ForceFront(ch)
+int ch;
+{
+	++fe_now;
+
+	if(!fe_get)
+		fe_get = FORCED_MAX;
+
+	fe_dat[--fe_get] = ch;
+}
+
+/* Get next character from forced entry buffer
+   -------------------------------------------
+*/
+ForcePop()
+{
+	--fe_now;
+
+	if(fe_get == FORCED_MAX)
+		fe_get = 0;
+
+	return fe_dat[fe_get++];
+}
+
+/* Tell if a key does its repeats at once
+   --------------------------------------
+   Other keys are returned once for each repeat.
+*/
+ForceCanRep(ch)
+int ch;
+{
+	switch(ch)
+	{
+		case K_UP :
+		case K_DOWN :
+		case K_LEFT :
+		case K_RIGHT :
+		case K_LDEL :
+		case K_RDEL :
+		case K_TAB :
+		case K_DELETE :
+		case K_PASTE :
+			return 1;
+	}
+
+	return 0;
+}
+
 /* Return character from forced entry buffer, or keyboard
    ------------------------------------------------------
+   Sets fe_rep to the # of repeats of the key -- see ForceRep().
 */
 ForceGetCh()
 {
+	int ch;
+
+	fe_rep = 1;
+
 	if(fe_now)
 	{
-		--fe_now;
+		fe_forced = 1;
 
-		if(fe_get == FORCED_MAX)
-			fe_get = 0;
+		if((ch = ForcePop()) == FORCED_REP)
+		{
+			fe_rep = ForcePop(); ch = ForcePop();
 
-		fe_forced = 1;
+			if(!ForceCanRep(ch))
+			{
+				ForceAgain(ch, fe_rep - 1);
+
+				fe_rep = 1;
+			}
+		}
 
-		return fe_dat[fe_get++];
+		return ch;
 	}
 
 #if OPT_MACRO
@@ -487,4 +704,3 @@ int len, ch;
 	}
 }
 
-
\ No newline at end of file
@@ -24,6 +24,10 @@
 
 	30 Jan 2018 : Extracted from te.c.
 	25 Sep 2021 : Restore system message and cursor position when editing in ErrLine().
+	17 Oct 2026 : Added ErrLineSwap().
+	17 Oct 2026 : Print the message with BatchErr() in batch mode.
+	17 Oct 2026 : Added WarnLine().
+	17 Oct 2026 : Added ErrLineForced().
 */
 
 /* Print error message and wait for a key press
@@ -32,6 +36,15 @@
 ErrLine(s)
 char *s;
 {
+#if OPT_BATCH
+
+	if(bt_mode)
+	{
+		BatchErr(s); return;
+	}
+
+#endif
+
 	SysLineCont(s);
 	
 	/* Restore system message and cursor position when editing */
@@ -41,8 +54,27 @@ char *s;
 		
 		sysln = 0;
 		
-		CrtLocate(BOX_ROW + box_shr, box_shc + cf_num);
+		MoveTo(BOX_ROW + box_shr, box_shc + cf_num);
+	}
+}
+
+/* Print notice message and wait for a key press
+   ---------------------------------------------
+   As ErrLine(), but it's not an error in batch mode.
+*/
+WarnLine(s)
+char *s;
+{
+#if OPT_BATCH
+
+	if(bt_mode)
+	{
+		BatchWarn(s); return;
 	}
+
+#endif
+
+	ErrLine(s);
 }
 
 /* No memory error
@@ -69,6 +101,14 @@ ErrLineOpen()
 	ErrLine("Can't open");
 }
 
+/* Swap file error
+   ---------------
+*/
+ErrLineSwap()
+{
+	ErrLine("Swap file error");
+}
+
 /* Too many lines error
    --------------------
 */
@@ -77,4 +117,11 @@ ErrLineTooMany()
 	ErrLine("Too many lines");
 }
 
-
\ No newline at end of file
+/* Forced entry buffer full error
+   ------------------------------
+*/
+ErrLineForced()
+{
+	ErrLine("Too many keys");
+}
+
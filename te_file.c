@@ -28,6 +28,20 @@
 	16 Jan 2019 : Added support for block selection.
 	19 Jan 2019 : Optimize WriteFile().
 	04 Jan 2021 : Use configuration variables.
+	17 Oct 2026 : Use GetLine(). Free only the lines in use, the gap can hold stale pointers.
+	17 Oct 2026 : Use LineAlloc(), LineFree().
+	17 Oct 2026 : Grow the lines array while reading.
+	17 Oct 2026 : Support for swapped out lines. Use FreeLine(), PeekLine().
+	17 Oct 2026 : ReadFile() reads the file in blocks, and checks the characters while splitting the lines.
+	17 Oct 2026 : ReadFile() reads files with CR + LF line ends in place.
+	17 Oct 2026 : ReadFile() reads only the first lines. Added ReadMore(), ReadAll(), ReadStop().
+	17 Oct 2026 : Flush the output before reading or writing.
+	17 Oct 2026 : Added InsertFile(). ReadMore() can insert the lines before others.
+	17 Oct 2026 : WriteFile() removes the file from the compiled macros cache.
+	17 Oct 2026 : Added ReadCopy(). Don't trust the size from fsize().
+	17 Oct 2026 : ReadMore() moves the gap only if there are lines to add.
+	17 Oct 2026 : The notices of ReadMore() are not errors in batch mode: use WarnLine().
+	17 Oct 2026 : ReadFile() reads files with LF line ends in place under OS_POSIX.
 */
 
 /* Reset lines array
@@ -37,9 +51,25 @@ ResetLines()
 {
 	int i;
 
-	FreeArray(lp_arr, cf_mx_lines, 0);
+	/* Stop reading the current file, if any */
+	ReadStop();
 
-	lp_cur = lp_now = lp_chg = box_shr = box_shc = 0;
+	for(i = 0; i < lp_now; ++i) {
+		FreeLine(i);
+	}
+
+	/* Free the file read in place, if any */
+	if(la_map) {
+		free(la_map); la_map = NULL;
+	}
+
+	lp_cur = lp_now = lp_gap = lp_chg = box_shr = box_shc = 0;
+
+#if OPT_SWAP
+
+	SwapReset();
+
+#endif
 
 #if OPT_BLOCK
 
@@ -68,101 +98,387 @@ NewFile()
 /* Read text file
    --------------
    Returns NZ on error.
+
+   Only the first lines of the file are read here, enough to fill the
+   editor box. The rest of them are read later by ReadMore(), while the
+   user is editing -- see Loop() and GetKey().
+
+   Files with CR + LF line ends are read in place if they fit in memory:
+   the whole file is read into a buffer, and the CR + LF of each line
+   become the ZERO of the line and the header of the next one, as a record
+   of size class 0 -- see LineFree(). These lines are copied by LineAlloc()
+   the first time they are modified, as they have no room to grow. With
+   OPT_SWAP, the lines at odd addresses are copied while reading.
+
+   Under OS_POSIX, files with LF line ends are read in place too. The file
+   is read after some free bytes (the slack) at the start of the buffer,
+   and each line is moved back to make room for its header, one byte more
+   than the LF. The lines that find no room are copied -- see ReadMore().
+
+   The size from fsize() can be wrong (it wraps at 64K). If the file is
+   bigger than the buffer, the rest of the lines are copied -- see
+   ReadCopy().
 */
 ReadFile(fn)
 char *fn;
 {
 	FILE *fp;
-	int ch, code, len, i, tabs, rare;
-	unsigned char *p;
+	int len, lf;
+	unsigned int size, top, slack;
+	unsigned char *buf, *p;
 
 	/* Free current contents */
 	ResetLines();
 
-	/* Setup some things */
-	code = tabs = rare = 0;
-
 	/* Open the file */
-	SysLine("Reading file... ");
+	SysLine("Reading file... "); CrtFlush();
+
+	if(!(buf = AllocMem(RD_BUF_SIZ)))
+		return -1;
 
-	if(!(fp = fopen(fn, "r")))
+	if(!(fp = fopen(fn, "rb")))
 	{
-		ErrLineOpen(); return -1;
+		free(buf); ErrLineOpen(); return -1;
 	}
 
-	/* Read the file */
-	for(i = 0; i < 32000; ++i)
+	/* Read the first block */
+	rd_size = RD_BUF_SIZ;
+	rd_beg = rd_end = 0;
+	rd_map = rd_crlf = rd_tabs = rd_rare = 0;
+
+	rd_eof = ((top = fread(buf, 1, RD_BUF_SIZ, fp)) < RD_BUF_SIZ);
+
+	/* Read the whole file in place if the first line ends with CR + LF,
+	   or with LF under OS_POSIX */
+	if(!rd_eof)
 	{
-		if(!fgets(ln_dat, ln_max + 2, fp)) /* ln_max + CR + ZERO */
-			break;
+		for(len = 0; len < top && buf[len] != '\n'; ++len)
+			;
+
+#ifdef OS_POSIX
+		lf = (len < top && len && buf[len - 1] != '\r');
+#else
+		lf = 0;
+#endif
 
-		if(lp_now == cf_mx_lines)
+		if(len && len < top && (lf || buf[len - 1] == '\r') && (size = fsize(fn)) != -1 && size >= top)
 		{
-			ErrLineTooMany(); ++code; break;
+			/* With LF, one byte more for each line, if they have 4 characters
+			   or more on average */
+			slack = (lf ? size / 4 + 1 : 0);
+
+			/* Room for the header of the first line, and the ZERO of the last one */
+			if(size + slack + 3 > size && (p = malloc(size + slack + 3)))
+			{
+				memcpy(p + slack + 2, buf, top);
+
+				free(buf);
+
+				la_map = buf = p;
+
+				rd_size = size + slack + 2;
+
+				top += slack + 2; rd_beg = rd_end = slack + 2;
+
+				rd_map = rd_crlf = 1; rd_put = 0;
+			}
 		}
+	}
 
-		len = strlen(ln_dat);
+	rd_fp = fp; rd_buf = buf; rd_top = top;
+
+	/* Read the first lines */
+	return ReadMore(box_rows - 1);
+}
+
+/* Insert text file
+   ----------------
+   Returns NZ on error.
+
+   The lines are inserted before the current one, all of them at once:
+   ReadMore() reads them into the gap of the lines array, as if it were
+   at the end of the text.
+*/
+InsertFile(fn)
+char *fn;
+{
+	FILE *fp;
+	unsigned char *buf;
+	int code, n;
+
+	/* Read the rest of the current file first */
+	if(rd_fp && ReadAll())
+		return -1;
 
-		if(ln_dat[len - 1] == '\n')
-			ln_dat[--len] = 0;
-		else if(len > ln_max)
+	SysLine("Reading file... "); CrtFlush();
+
+	if(!(buf = AllocMem(RD_BUF_SIZ)))
+		return -1;
+
+	if(!(fp = fopen(fn, "rb")))
+	{
+		free(buf); ErrLineOpen(); return -1;
+	}
+
+	/* ReadMore() reads the first block */
+	rd_size = RD_BUF_SIZ;
+	rd_beg = rd_end = rd_top = 0;
+	rd_eof = rd_map = rd_crlf = rd_tabs = rd_rare = 0;
+
+	rd_fp = fp; rd_buf = buf;
+
+	rd_tail = lp_now - lp_cur;
+
+	n = lp_now;
+
+	code = ReadMore(LP_LIMIT);
+
+	rd_tail = 0;
+
+	if(lp_now != n)
+		lp_chg = 1;
+
+	return code;
+}
+
+/* Read more lines of the file being read
+   --------------------------------------
+   Read lines until line # is in memory, or the end of the file. Returns NZ
+   on error, and then the filename is cleared, as the text is incomplete.
+*/
+ReadMore(line)
+int line;
+{
+	int ch, code, len, i;
+	unsigned int n;
+	unsigned char *p;
+
+#if OPT_SWAP
+
+	WORD w;
+
+#endif
+
+	if(!rd_fp)
+		return 0;
+
+	ch = code = 0;
+
+	/* Split the data in lines, and read more blocks as needed */
+
+	while(lp_now <= line)
+	{
+		/* Get more data, keep the current line and one more character to check CR + LF */
+		if(rd_end + 1 >= rd_top && !rd_eof)
 		{
-			ErrLineLong(); ++code; break;
+			/* The buffer of a file read in place has room for all the data,
+			   unless the file is bigger than told by fsize() */
+			if(rd_map && rd_top == rd_size && fread(rd_buf + rd_top, 1, 1, rd_fp) == 1)
+			{
+				if(ReadCopy())
+				{
+					++code; break;
+				}
+			}
+
+			if(!rd_map)
+			{
+				for(n = rd_beg; n < rd_top; ++n)
+					rd_buf[n - rd_beg] = rd_buf[n];
+
+				rd_end -= rd_beg; rd_top -= rd_beg; rd_beg = 0;
+			}
+
+			if((n = rd_size - rd_top) > RD_BUF_SIZ)
+				n = RD_BUF_SIZ;
+
+			if(!n || (len = fread(rd_buf + rd_top, 1, n, rd_fp)) < n)
+				rd_eof = 1;
+
+			if(n)
+				rd_top += len;
 		}
 
-		if(!(lp_arr[lp_now] = AllocMem(len + 1)))
+		/* No more data is the same as EOF */
+		ch = (rd_end < rd_top ? rd_buf[rd_end] : CPM_EOF);
+
+		if(ch == '\n' || ch == CPM_EOF || (ch == '\r' && rd_end + 1 < rd_top && rd_buf[rd_end + 1] == '\n'))
 		{
-			++code; break;
-		}
+			/* End of line */
+			if(ch == CPM_EOF && rd_end == rd_beg)
+				break;
+
+			if(!GrowLines(1))
+			{
+				++code; break;
+			}
+
+			len = rd_end - rd_beg;
+
+			/* In place, the header goes after the ZERO of the previous line */
+			p = rd_buf + (n = rd_put + 2);
+
+#if OPT_SWAP
+
+			/* Text pointers must be even -- see te_swap.c */
+			if((w = p) & 1)
+			{
+				++p; ++n;
+			}
+
+#endif
+
+			if(rd_map && n <= rd_beg)
+			{
+				/* The text is moved back if the previous line had no CR */
+				if(n < rd_beg)
+				{
+					for(i = 0; i < len; ++i)
+						p[i] = rd_buf[rd_beg + i];
+				}
+
+				p[-2] = 0; p[-1] = len;
 
-		p = strcpy(lp_arr[lp_now++], ln_dat);
+				rd_put = n + len;
+			}
+			else if((p = LineAlloc(len, 0)))
+			{
+				memcpy(p, rd_buf + rd_beg, len);
+			}
+			else
+			{
+				++code; break;
+			}
+
+			p[len] = '\0';
+
+			/* The gap must be at the end of the array, or before the lines
+			   that follow the inserted ones -- see InsertFile(). It's moved
+			   only once, and only if there is a line to add. */
+			if(lp_gap != lp_now - rd_tail)
+				MoveGap(lp_now - rd_tail);
+
+			lp_arr[lp_gap++] = p; ++lp_now;
+
+			if(ch == CPM_EOF)
+				break;
+
+			rd_crlf = (ch == '\r');
 
-		/* Change TABs to SPACEs, and check characters */
-		//while((ch = (*p & 0xFF)))
-		while((ch = *p))
+			rd_beg = (rd_end += (rd_crlf ? 2 : 1));
+		}
+		else
 		{
+			if(rd_end - rd_beg == ln_max)
+			{
+				ErrLineLong(); ++code; break;
+			}
+
+			/* Change TABs to SPACEs, and check characters */
 			if(ch < ' ')
 			{
 				if(ch == '\t')
 				{
-					*p = ' '; ++tabs;
+					rd_buf[rd_end] = ' '; ++rd_tabs;
 				}
 				else
 				{
-					*p = '?'; ++rare;
+					rd_buf[rd_end] = '?'; ++rd_rare;
 				}
 			}
 
-			++p;
+			++rd_end;
 		}
 	}
 
-	/* Close the file */
-	fclose(fp);
-
 	/* Check errors */
 	if(code)
+	{
+		ReadStop();
+
+		/* The text is incomplete, unless a file was being inserted */
+		if(!rd_tail)
+			file_name[0] = '\0';
+
 		return -1;
+	}
 
-	/* Check if empty file */
-	if(!lp_now)
+	/* Check if end of file */
+	if(ch == CPM_EOF)
 	{
-		/* Build first line */
-		InsertLine(0, NULL);
-	}
+		ReadStop();
+
+		/* Check if empty file */
+		if(!lp_now)
+		{
+			/* Build first line */
+			InsertLine(0, NULL);
+		}
 
-	/* Check TABs */
-	if(tabs)
-		ErrLine("Tabs changed to spaces");
+		/* Check TABs */
+		if(rd_tabs)
+			WarnLine("Tabs changed to spaces");
 
-	/* Check rare chars. */
-	if(rare)
-		ErrLine("Illegal characters changed to '?'");
+		/* Check rare chars. */
+		if(rd_rare)
+			WarnLine("Illegal characters changed to '?'");
+	}
 
 	/* Success */
 	return 0;
 }
 
+/* Stop reading the file in place
+   ------------------------------
+   Returns NZ on error.
+
+   The lines already read stay in place, and the rest are copied. The data
+   not split yet, plus the character past the end of the buffer, is moved
+   to a new buffer.
+*/
+ReadCopy()
+{
+	unsigned char *buf;
+	unsigned int n;
+
+	if(!(buf = AllocMem(RD_BUF_SIZ)))
+		return -1;
+
+	for(n = rd_beg; n <= rd_top; ++n)
+		buf[n - rd_beg] = rd_buf[n];
+
+	rd_end -= rd_beg; rd_top -= rd_beg - 1; rd_beg = 0;
+
+	rd_buf = buf; rd_size = RD_BUF_SIZ; rd_map = 0;
+
+	return 0;
+}
+
+/* Read the rest of the file being read
+   ------------------------------------
+   Returns NZ on error.
+*/
+ReadAll()
+{
+	return ReadMore(LP_LIMIT);
+}
+
+/* Stop reading the file
+   ---------------------
+*/
+ReadStop()
+{
+	if(rd_fp)
+	{
+		/* Close the file */
+		fclose(rd_fp); rd_fp = NULL;
+
+		/* The buffer of a file read in place holds the lines */
+		if(!rd_map)
+			free(rd_buf);
+	}
+}
+
 /* Backup the previous file with the same name
    -------------------------------------------
    Return NZ on error.
@@ -199,7 +515,11 @@ char *fn;
 	FILE *fp;
 	int i;
 
-	SysLine("Writing file... ");
+	/* The file can be still being read */
+	if(ReadAll())
+		return -1;
+
+	SysLine("Writing file... "); CrtFlush();
 
 	/* Backup old file */
 	BackupFile(fn);
@@ -214,7 +534,7 @@ char *fn;
 	/* Write the file */
 	for(i = 0; i < lp_now; ++i)
 	{
-		if(fputs(lp_arr[i], fp) == EOF || fputc('\n', fp) == EOF) {
+		if(fputs(PeekLine(i), fp) == EOF || fputc('\n', fp) == EOF) {
 
 			fclose(fp); remove(fn);
 
@@ -234,8 +554,14 @@ char *fn;
 		return -1;
 	}
 
+#if OPT_MACRO
+
+	/* The file can be a compiled macro */
+	MacroForget(fn);
+
+#endif
+
 	/* Success */
 	return (lp_chg = 0);
 }
 
-
\ No newline at end of file
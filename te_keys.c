@@ -29,6 +29,9 @@
 	04 Apr 2021 : Remove customized key names. Use key bindings from configuration.
 	11 May 2021 : Update keys purposes.
 	10 Jul 2021 : Remove SetKey().
+	17 Oct 2026 : Flush the output before waiting for a key.
+	17 Oct 2026 : There is no keyboard in batch mode.
+	17 Oct 2026 : Read more lines of the file while waiting for a key.
 */
 
 /* Return key name
@@ -109,6 +112,38 @@ GetKey()
 {
 	int c, x, i, k;
 
+#if OPT_BATCH
+
+	/* No keyboard in batch mode: end the editing -- see te_batch.c */
+	if(bt_mode) {
+		return K_ESC;
+	}
+
+#endif
+
+	/* Read more lines of the file being read, while there are no keys
+	   waiting. Only if the editor is waiting for a key -- see BfEdit() */
+	if(rd_idle && rd_fp && !CrtStat()) {
+		rd_idle = 0;
+
+		do {
+			/* On error, the filename was cleared -- see ReadMore() */
+			if(ReadMore(lp_now + RD_SLICE)) {
+				ShowFilename();
+			}
+		} while(rd_fp && !CrtStat());
+
+		/* Print the # of lines, and put the cursor back */
+		cr_row = -1;
+
+		ShowInfo();
+
+		Locate(BOX_ROW + box_shr, cf_num + box_shc);
+	}
+
+	/* Show the output before waiting for a key */
+	CrtFlush();
+
 	c = CrtIn();
 
 	if(c > 31 && c != 127) {
@@ -142,4 +177,3 @@ GetKey()
 	return '?';
 }
 
-
\ No newline at end of file
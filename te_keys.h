@@ -99,4 +99,3 @@
 #define ESC   27
 #define DEL   127
 
-
\ No newline at end of file
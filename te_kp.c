@@ -53,6 +53,8 @@
 	11 May 2021 : Remove CRT configuration values.
 	30 Jun 2021 : Added CRT_DEF_ROWS, CRT_DEF_COLS.
 	06 Jul 2021 : Optimize CrtOut().
+	17 Oct 2026 : Added CrtInsLine(), CrtDelLine().
+	17 Oct 2026 : Added CrtStat().
 
 	Notes:
 
@@ -76,6 +78,11 @@
 #define OPT_BLOCK 1  /* Block selection */
 #define OPT_MACRO 1  /* Enable macros */
 
+/* Definitions
+   -----------
+*/
+#define CRT_CAN_INS 1    /* Insert and delete lines are available */
+
 /* Include main code
    -----------------
 */
@@ -147,6 +154,21 @@ CrtIn:
 	ret
 #endasm
 
+/* Check if there is a key waiting
+   -------------------------------
+   Return NZ if there is a key, else Z. Used to skip screen updates while
+   the user is typing ahead.
+
+   int CrtStat(void)
+*/
+#asm
+CrtStat:
+	call BiosConst
+	ld h,0
+	ld l,a
+	ret
+#endasm
+
 /* Clear screen and send cursor to 0,0
    -----------------------------------
    void CrtClear(void)
@@ -193,4 +215,24 @@ int on;
 	CrtOut(27); CrtOut(on ? 'B' : 'C'); CrtOut('0');
 }
 
+/* Insert a blank line, the following lines go down
+   -------------------------------------------------
+*/
+CrtInsLine(row)
+int row;
+{
+	CrtLocate(row, 0);
+	CrtOut(27); CrtOut('E');
+}
+
+/* Delete a line, the following lines go up
+   ----------------------------------------
+*/
+CrtDelLine(row)
+int row;
+{
+	CrtLocate(row, 0);
+	CrtOut(27); CrtOut('R');
+}
+
 
\ No newline at end of file
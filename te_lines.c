@@ -26,8 +26,175 @@
 	07 Jan 2019 : Added InsertLine(), AppendLine(), SplitLine(), DeleteLine(), JoinLines().
 	08 Jan 2019 : Added SetLine(), ModifyLine(), ClearLine(). Modified InsertLine().
 	04 Jan 2021 : Use configuration variables.
+	17 Oct 2026 : The lines array is now a gap buffer. Added GetLine(), GapIndex(), MoveGap().
+	17 Oct 2026 : Added DeleteLines(), InsertLines().
+	17 Oct 2026 : Use LineAlloc(), LineFree().
+	17 Oct 2026 : Modify, split and join lines in place when there is room.
+	17 Oct 2026 : Use LineLen().
+	17 Oct 2026 : The lines array grows as needed. Added GrowLines().
+	17 Oct 2026 : Lines can be swapped out. Added PeekLine(), FreeLine().
+	17 Oct 2026 : SetLine() doesn't read back the swapped out lines it replaces.
+
+	Notes:
+
+	The lines array is a gap buffer: lines before lp_gap are at the start of
+	the array, the rest of them are at the end, and the free slots are in the
+	middle. The gap follows the line being edited, so inserting or deleting
+	lines near the cursor doesn't shift the whole array.
+
+	Always use GetLine() to read a line, never lp_arr[] directly: the line
+	can be in the swap file -- see te_swap.c. PeekLine() is cheaper if the
+	line is only going to be read.
+
+	The array has room for lp_max lines, and it grows by LP_CHUNK lines
+	when it is full, until there is no more memory or LP_LIMIT is reached.
 */
 
+/* Return array index of line #
+   ----------------------------
+*/
+GapIndex(line)
+int line;
+{
+	return line < lp_gap ? line : line + lp_max - lp_now;
+}
+
+/* Return text of line #
+   ---------------------
+   Returns NULL if the line is swapped out, and there is no memory to read
+   it back -- see SwapIn(). Use PeekLine() to read a line only.
+*/
+GetLine(line)
+int line;
+{
+#if OPT_SWAP
+
+	int i;
+
+	sw_last = line;
+
+	if(lp_arr[(i = GapIndex(line))] & 1) {
+		return SwapIn(i);
+	}
+
+	return lp_arr[i];
+
+#else
+
+	return lp_arr[GapIndex(line)];
+
+#endif
+}
+
+/* Return text of line # to read it only
+   -------------------------------------
+   The text of a swapped out line is valid until next call.
+*/
+PeekLine(line)
+int line;
+{
+#if OPT_SWAP
+
+	WORD w;
+
+	if((w = lp_arr[GapIndex(line)]) & 1) {
+		return SwapPeek(w);
+	}
+
+	return w;
+
+#else
+
+	return lp_arr[GapIndex(line)];
+
+#endif
+}
+
+/* Free text of line #
+   -------------------
+*/
+FreeLine(line)
+int line;
+{
+#if OPT_SWAP
+
+	/* Nothing to do for swapped out lines */
+	if(lp_arr[GapIndex(line)] & 1) {
+		return;
+	}
+
+#endif
+
+	LineFree(GetLine(line));
+}
+
+/* Move the gap before line #
+   --------------------------
+*/
+MoveGap(line)
+int line;
+{
+	int gap;
+
+	gap = lp_max - lp_now;
+
+	while(lp_gap > line) {
+		--lp_gap;
+		lp_arr[lp_gap + gap] = lp_arr[lp_gap];
+	}
+
+	while(lp_gap < line) {
+		lp_arr[lp_gap] = lp_arr[lp_gap + gap];
+		++lp_gap;
+	}
+}
+
+/* Make room in the array for 'count' new lines
+   ---------------------------------------------
+   Return NZ on success, else Z.
+*/
+GrowLines(count)
+int count;
+{
+	WORD *arr;
+	int max, i, tail;
+
+	if(lp_now + count <= lp_max) {
+		return 1;
+	}
+
+	for(max = lp_max; max < lp_now + count; max += LP_CHUNK)
+		;
+
+	if(max > LP_LIMIT) {
+		ErrLineTooMany();
+
+		return 0;
+	}
+
+	if(!(arr = AllocMem(max * SIZEOF_PTR))) {
+		return 0;
+	}
+
+	/* Copy the lines before the gap, and the lines after it */
+	for(i = 0; i < lp_gap; ++i) {
+		arr[i] = lp_arr[i];
+	}
+
+	tail = lp_now - lp_gap;
+
+	for(i = 1; i <= tail; ++i) {
+		arr[max - i] = lp_arr[lp_max - i];
+	}
+
+	free(lp_arr);
+
+	lp_arr = arr;
+	lp_max = max;
+
+	return 1;
+}
+
 /* Return line # of first line printed on the editor box
    -----------------------------------------------------
 */
@@ -56,11 +223,10 @@ SetLine(line, text, insert)
 int line; char *text; int insert;
 {
 	char *p;
-	int i;
+	int len;
+	WORD w;
 	
-	if(insert && lp_now >= cf_mx_lines) {
-		ErrLineTooMany();
-		
+	if(insert && !GrowLines(1)) {
 		return 0;
 	}
 
@@ -68,21 +234,40 @@ int line; char *text; int insert;
 		text = "";
 	}
 
-	if((p = AllocMem(strlen(text) + 1))) {
+	len = strlen(text);
+
+	if(!insert) {
+		/* Modify the line in place if there is room. A swapped out line
+		   is not read back, as it's replaced -- see FreeLine(). */
+		w = lp_arr[GapIndex(line)];
+
+#if OPT_SWAP
+
+		if(w & 1) {
+			w = 0;
+		}
+
+#endif
+
+		if(w && len <= LineCap(p = w)) {
+			LineSetLen(strcpy(p, text), len);
+
+			return 1;
+		}
+	}
+
+	if((p = LineAlloc(len, LA_SLACK))) {
 		if(insert) {
-			for(i = lp_now; i > line; --i) {
-				lp_arr[i] = lp_arr[i - 1];
-			}
+			MoveGap(line);
 
+			++lp_gap;
 			++lp_now;
 		}
 		else {
-			if(lp_arr[line]) {
-				free(lp_arr[line]);
-			}
+			FreeLine(line);
 		}
 
-		lp_arr[line] = strcpy(p, text);
+		lp_arr[GapIndex(line)] = strcpy(p, text);
 
 		return 1;
 	}
@@ -139,26 +324,20 @@ int line; char *text;
 SplitLine(line, pos)
 int line, pos;
 {
-	char *p, *p2;
-
-	if((p = AllocMem(pos + 1))) {
-		if(AppendLine(line, lp_arr[line] + pos)) {
-
-			/* We don't have strncpy() nor arrays of pointers yet, then... */
-			p2 = lp_arr[line];
-
-			p2[pos] = '\0';
+	char *p;
 
-			strcpy(p, p2);
+	if(!(p = GetLine(line))) {
+		return 0;
+	}
 
-			free(p2);
+	if(AppendLine(line, p + pos)) {
 
-			lp_arr[line] = p;
+		/* The first half stays in place */
+		p[pos] = '\0';
 
-			return 1;
-		}
+		LineSetLen(p, pos);
 
-		free(p);
+		return 1;
 	}
 
 	return 0;
@@ -171,21 +350,55 @@ int line, pos;
 DeleteLine(line)
 int line;
 {
-	int i;
+	return DeleteLines(line, 1);
+}
 
-	free(lp_arr[line]);
+/* Delete 'count' lines from line #
+   --------------------------------
+   Return NZ on success, else Z.
+*/
+DeleteLines(line, count)
+int line, count;
+{
+	MoveGap(line);
 
-	--lp_now;
+	/* Each deleted line makes the gap bigger */
+	while(count--) {
+		FreeLine(line);
 
-	for(i = line; i < lp_now; ++i) {
-		lp_arr[i] = lp_arr[i + 1];
+		--lp_now;
 	}
 
-	lp_arr[lp_now] = NULL;
-
 	return 1;
 }
 
+/* Insert 'count' lines from array before line #
+   ---------------------------------------------
+   Return the # of lines inserted, Z on failure.
+*/
+InsertLines(line, arr, count)
+int line; WORD *arr; int count;
+{
+	int i;
+	char *p;
+
+	if(!GrowLines(count)) {
+		return 0;
+	}
+
+	MoveGap(line);
+
+	for(i = 0; i < count; ++i) {
+		if(!(p = LineAlloc(LineLen(arr[i]), 0))) {
+			break;
+		}
+
+		lp_arr[lp_gap++] = strcpy(p, arr[i]); ++lp_now;
+	}
+
+	return i;
+}
+
 /* Join two consecutive lines
    --------------------------
    Return NZ on success, else Z.
@@ -196,36 +409,36 @@ int line;
 	char *p, *p1, *p2;
 	int s1, s2;
 
-	p1 = lp_arr[line];
-	p2 = lp_arr[line + 1];
+	if(!(p1 = GetLine(line)) || !(p2 = GetLine(line + 1))) {
+		return 0;
+	}
 
-	s1 = strlen(p1);
-	s2 = strlen(p2);
+	s1 = LineLen(p1);
+	s2 = LineLen(p2);
 
 	if(s1 + s2 <= ln_max) {
-		if((p = AllocMem(s1 + s2 + 1))) {
-
-			/*
-			strcpy(p, p1); strcat(p, p2);
+		if(s1 + s2 <= LineCap(p1)) {
+			/* Join the lines in place */
+			strcpy(p1 + s1, p2);
 
-			lp_arr[line] = p;
-			*/
-
-			//
-			lp_arr[line] = strcat(strcpy(p, p1), p2);
-			//
+			LineSetLen(p1, s1 + s2);
+		}
+		else if((p = LineAlloc(s1 + s2, LA_SLACK))) {
+			strcpy(p, p1); strcpy(p + s1, p2);
 
-			//lp_arr[line] = strcpy(strcpy(p, p1) + s1, p2);  FIXME - What's wrong with this?
+			lp_arr[GapIndex(line)] = p;
 
-			free(p1);
+			LineFree(p1);
+		}
+		else {
+			return 0;
+		}
 
-			DeleteLine(line + 1);
+		DeleteLine(line + 1);
 
-			return 1;
-		}
+		return 1;
 	}
 
 	return 0;
 }
 
-
\ No newline at end of file
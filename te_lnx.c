@@ -0,0 +1,600 @@
+/*	te_lnx.c
+
+	Text editor -- version for Linux and other POSIX systems.
+
+	Copyright (c) 2015-2026 Miguel Garcia / FloppySoftware
+
+	This program is free software; you can redistribute it and/or modify it
+	under the terms of the GNU General Public License as published by the
+	Free Software Foundation; either version 2, or (at your option) any
+	later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+	Usage:
+
+	te_lnx [-R|-P trace] [filename]
+	te_lnx -m macro file...
+
+	Compilation:
+
+	gcc -std=gnu89 -no-pie -Wall -Wno-implicit -Wno-return-type -Wno-int-conversion \
+	    -Wno-incompatible-pointer-types -Wno-pointer-sign -o te_lnx te_lnx.c
+
+	The warnings turned off are the ones of the MESCC style: functions
+	without return type, and used before their definition, and pointers
+	kept in int variables.
+
+	Changes:
+
+	17 Oct 2026 : 1st version.
+	17 Oct 2026 : Runs on 64 bits systems. Added main(), OsRun().
+
+	Notes:
+
+	It runs on an ANSI terminal, with the tty in raw mode. The output is
+	buffered, and written with write().
+
+	The screen size is taken from the tty (TIOCGWINSZ) on start, and each
+	time it changes (SIGWINCH).
+
+	TE keeps pointers in int variables, as under CP/M, so all the memory
+	it uses must be in the first 2 GB. On 64 bits systems, the heap is
+	taken from the data segment only, that is there if the program is
+	not position independent (-no-pie), and TE runs on a stack taken
+	from the heap -- see main(). On 32 bits systems (-m32), there is
+	nothing to do.
+
+	The few BDOS functions used by TE are emulated by bdos_a(), and the
+	configuration block is in C -- see te_conf.c. The keys are the same
+	of the te_ansi adaptation.
+*/
+
+/* System libraries
+   ----------------
+   Instead of the MESCC ones -- see te.c.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/ioctl.h>
+#include <sys/select.h>
+#include <sys/stat.h>
+#include <malloc.h>
+#include <ucontext.h>
+
+/* MESCC definitions
+   -----------------
+*/
+#define WORD       unsigned int
+#define SIZEOF_PTR 4
+#define SIZEOF_INT 4
+
+#undef  FILENAME_MAX
+#define FILENAME_MAX 24
+
+/* Default configuration values
+   ----------------------------
+*/
+#define CRT_DEF_ROWS 25
+#define CRT_DEF_COLS 80
+
+/* Options
+   -------
+   Set to 1 to add the following functionalities, else 0.
+*/
+#define OPT_LWORD 0  /* Go to word on the left */
+#define OPT_RWORD 0  /* Go to word on the right */
+#define OPT_FIND  1  /* Find string */
+#define OPT_GOTO  1  /* Go to line # */
+#define OPT_BLOCK 1  /* Block selection */
+#define OPT_MACRO 1  /* Enable macros */
+#define OPT_TRACE 1  /* Record and play back key traces */
+#define OPT_SWAP  0  /* There is memory enough */
+#define OPT_Z80   0  /* It's not a Z80 */
+
+/* Definitions
+   -----------
+*/
+#define OS_POSIX     1    /* Not CP/M */
+#define LA_GRAN      8    /* Line storage: >= 2 + SIZEOF_PTR */
+#define CRT_CAN_INS  1    /* Insert and delete lines are available */
+#define CRT_LOC_COST 7    /* ESC [ row ; col H */
+#define CRT_OUT_BUF  1    /* Buffered output */
+#define CRT_OUT_SIZ  1024 /* Output buffer size */
+#define CRT_RESIZE   1    /* The screen can be resized */
+#define OS_STACK     65536 /* Stack size for TE -- see main() */
+
+/* Functions used by TE before their definition
+   --------------------------------------------
+*/
+int fsize();
+
+/* Include main code
+   -----------------
+   Its main() is TeMain() -- see main() below.
+*/
+#define main TeMain
+
+#include "te.c"
+
+#undef main
+
+/* Configuration variables -- see te_conf.c
+   ----------------------------------------
+*/
+unsigned int cf_start;
+unsigned char cf_version = 2;
+char cf_name[32] = "Linux terminal";
+unsigned char cf_rows = 0;    /* Auto */
+unsigned char cf_cols = 0;    /* Auto */
+int cf_mx_lines = 512;
+unsigned char cf_tab_cols = 4;
+unsigned char cf_num = 5;
+unsigned char cf_clang = 1;
+unsigned char cf_indent = 1;
+unsigned char cf_list = 1;
+char cf_list_chr[8] = "-*>";
+unsigned char cf_rul_chr = '.';
+unsigned char cf_rul_tab = '!';
+unsigned char cf_vert_chr = '|';
+unsigned char cf_horz_chr = '-';
+unsigned char cf_lnum_chr = '|';
+char cf_cr_name[8] = "ENTER";
+char cf_esc_name[8] = "ESC";
+
+/* Key bindings, in the order of te_keys.h */
+unsigned char cf_keys[KEYS_MAX] = {
+	CTL_E, CTL_X, CTL_S, CTL_D, CTL_V, CTL_A, CTL_P, CTL_F,
+	CTL_R, CTL_C, CTL_I, CTL_M, ESC,   DEL,   CTL_H, CTL_U,
+	CTL_O, CTL_W, CTL_G, CTL_T, CTL_K, CTL_L, CTL_J, 0,
+	0,     CTL_B, CTL_B, CTL_B, CTL_Y
+};
+
+unsigned char cf_keys_ex[KEYS_MAX] = {
+	0,     0,     0,     0,     0,     0,     0,     0,
+	0,     0,     0,     0,     0,     0,     0,     0,
+	0,     0,     0,     0,     0,     0,     0,     0,
+	0,     'S',   'E',   'U',   0
+};
+
+int cf_bytes;
+
+/* Variables
+   ---------
+*/
+struct termios crt_tio; /* Settings of the tty on start */
+int crt_tty;            /* NZ if stdin is a tty */
+int crt_winch;          /* NZ if the tty was resized */
+
+ucontext_t os_main;     /* Context of main() */
+ucontext_t os_te;       /* Context of TE */
+int os_argc;            /* Arguments for TeMain() */
+char **os_argv;
+int os_code;            /* Exit code of TeMain() */
+
+/* Run TE
+   ------
+   void OsRun(void)
+*/
+void OsRun()
+{
+	os_code = TeMain(os_argc, os_argv);
+}
+
+/* Program entry
+   -------------
+   Runs TeMain() on a stack taken from the heap, and with the heap in the
+   data segment only, so all the pointers fit in int variables.
+*/
+int main(argc, argv)
+int argc; char *argv[];
+{
+	char *stk;
+
+#ifdef M_MMAP_MAX
+
+	mallopt(M_MMAP_MAX, 0);
+
+#endif
+
+	if(!(stk = malloc(OS_STACK)) || (unsigned long)stk + OS_STACK > 0x7FFFFFFFUL) {
+		fputs("te: no memory in the first 2 GB, compile with -no-pie\n", stderr);
+		return 1;
+	}
+
+	os_argc = argc; os_argv = argv;
+
+	getcontext(&os_te);
+
+	os_te.uc_stack.ss_sp = stk;
+	os_te.uc_stack.ss_size = OS_STACK;
+	os_te.uc_link = &os_main;
+
+	makecontext(&os_te, OsRun, 0);
+
+	swapcontext(&os_main, &os_te);
+
+	return os_code;
+}
+
+/* BDOS functions
+   --------------
+   Emulation of the ones used by TE: console output, version (CP/M 3),
+   screen size in the SCB, and date & time.
+
+   int bdos_a(int fn, int de)
+*/
+bdos_a(fn, de)
+int fn, de;
+{
+	unsigned char *p;
+	time_t t;
+	struct tm *tm;
+
+	p = de;
+
+	switch(fn) {
+		case 0x02 : /* Console output */
+			putchar(de);
+			return 0;
+		case 0x0C : /* Version */
+			return 0x31;
+		case 0x31 : /* Get SCB value */
+			return CrtSize(p[0] == 0x1C) - 1;
+		case 0x69 : /* Get date & time, in BCD */
+			time(&t); tm = localtime(&t);
+			p[0] = p[1] = 0;
+			p[2] = (tm->tm_hour / 10) << 4 | (tm->tm_hour % 10);
+			p[3] = (tm->tm_min / 10) << 4 | (tm->tm_min % 10);
+			return (tm->tm_sec / 10) << 4 | (tm->tm_sec % 10);
+	}
+
+	return 0xFF;
+}
+
+/* Return the size of a file in bytes, or -1 on error
+   --------------------------------------------------
+   int fsize(char *fn)
+*/
+fsize(fn)
+char *fn;
+{
+	struct stat st;
+
+	return stat(fn, &st) ? -1 : st.st_size;
+}
+
+/* Return the # of rows or columns of the tty
+   -------------------------------------------
+   int CrtSize(int rows)
+*/
+CrtSize(rows)
+int rows;
+{
+	struct winsize ws;
+	int n;
+
+	if(ioctl(1, TIOCGWINSZ, &ws) || !ws.ws_row || !ws.ws_col) {
+		return rows ? CRT_DEF_ROWS : CRT_DEF_COLS;
+	}
+
+	/* The configuration values are bytes */
+	n = (rows ? ws.ws_row : ws.ws_col);
+
+	return n > 255 ? 255 : n;
+}
+
+/* The tty was resized
+   -------------------
+   Signal handler for SIGWINCH. The change is done while waiting for a key.
+*/
+void CrtWinch(sig)
+int sig;
+{
+	crt_winch = 1;
+}
+
+/* Setup CRT: Used when the editor starts
+   --------------------------------------
+   void CrtSetup(void)
+*/
+CrtSetup()
+{
+	struct termios tio;
+	struct sigaction sa;
+
+	if((crt_tty = !tcgetattr(0, &crt_tio))) {
+		tio = crt_tio;
+
+		/* Raw input: no echo, no line editing, no signal keys, no XON/XOFF */
+		tio.c_iflag &= ~(BRKINT | ICRNL | INPCK | ISTRIP | IXON);
+		tio.c_lflag &= ~(ECHO | ICANON | IEXTEN | ISIG);
+		tio.c_cflag |= CS8;
+		tio.c_cc[VMIN] = 1;
+		tio.c_cc[VTIME] = 0;
+
+		tcsetattr(0, TCSAFLUSH, &tio);
+	}
+
+	/* No SA_RESTART: read() must return to CrtInEx() */
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = CrtWinch;
+	sigaction(SIGWINCH, &sa, NULL);
+
+	/* Use the alternate screen */
+	putstr("\033[?1049h");
+}
+
+/* Reset CRT: Used when the editor exits
+   -------------------------------------
+   void CrtReset(void)
+*/
+CrtReset()
+{
+	putstr("\033[?1049l");
+
+	CrtFlush();
+
+	if(crt_tty) {
+		tcsetattr(0, TCSAFLUSH, &crt_tio);
+	}
+}
+
+/* Write the output buffer
+   -----------------------
+   All program output is done with this function -- see CrtOut() in te_ui.c.
+
+   The tty translates '\n' to '\n' + '\r'.
+
+   void CrtWrite(char *buf, int len)
+*/
+CrtWrite(buf, len)
+char *buf; int len;
+{
+	int n;
+
+#if OPT_TRACE
+
+	TraceCount(len);
+
+#endif
+
+	while(len) {
+		if((n = write(1, buf, len)) > 0) {
+			buf += n; len -= n;
+		}
+		else if(n < 0 && errno != EINTR) {
+			break;
+		}
+	}
+}
+
+/* Input character from the keyboard
+   ---------------------------------
+   All program input is done with this function.
+
+   Translates the ANSI key codes into single characters.
+
+   int CrtIn(void)
+*/
+CrtIn()
+{
+	int ch, ex;
+
+	ch = CrtInEx();
+
+	/* BACKSPACE sends DEL */
+	if(ch == DEL) {
+		return CTL_H;
+	}
+
+	/* Translate key codes begining with 0x1B (ESC):
+
+	   UP:     ESC [ A   --> ^E
+	   DOWN:   ESC [ B   --> ^X
+	   RIGHT:  ESC [ C   --> ^D
+	   LEFT:   ESC [ D   --> ^S
+	   HOME:   ESC [ H   --> ^V
+	   END:    ESC [ F   --> ^A
+	   HOME:   ESC [ 1 ~ --> ^V
+	   DELETE: ESC [ 3 ~ --> DEL
+	   END:    ESC [ 4 ~ --> ^A
+	   PGUP:   ESC [ 5 ~ --> ^R
+	   PGDN:   ESC [ 6 ~ --> ^C
+	   HOME:   ESC [ 7 ~ --> ^V
+	   END:    ESC [ 8 ~ --> ^A
+	*/
+
+	if(ch == ESC && CrtInSt())
+	{
+		ch = 0;
+
+		if(CrtInEx() == '[' && CrtInSt())
+		{
+			switch((ex = CrtInEx()))
+			{
+				case 'A' : return CTL_E; /* UP */
+				case 'B' : return CTL_X; /* DOWN */
+				case 'C' : return CTL_D; /* RIGHT */
+				case 'D' : return CTL_S; /* LEFT */
+				case 'H' : return CTL_V; /* HOME */
+				case 'F' : return CTL_A; /* END */
+				case '1' :
+				case '3' :
+				case '4' :
+				case '5' :
+				case '6' :
+				case '7' :
+				case '8' :
+					if(CrtInSt() && CrtInEx() == '~')
+					{
+						switch(ex)
+						{
+							case '1' :
+							case '7' : return CTL_V; /* HOME */
+							case '3' : return DEL;   /* DELETE */
+							case '4' :
+							case '8' : return CTL_A; /* END */
+							case '5' : return CTL_R; /* PGUP */
+							case '6' : return CTL_C; /* PGDN */
+						}
+					}
+					break;
+			}
+		}
+	}
+
+	return ch;
+}
+
+/* Read a byte from the keyboard
+   -----------------------------
+   Resize the screen meanwhile, if the tty was resized.
+*/
+CrtInEx()
+{
+	unsigned char ch;
+	int n;
+
+	for(;;) {
+		if(crt_winch) {
+			crt_winch = 0;
+
+			SetScreenSize(CrtSize(1), CrtSize(0));
+
+			CrtFlush();
+		}
+
+		if((n = read(0, &ch, 1)) == 1) {
+			return ch;
+		}
+
+		/* End of input, or error */
+		if(!n || errno != EINTR) {
+			CrtClear(); CrtReset(); exit(1);
+		}
+	}
+}
+
+/* Wait a bit for the rest of a key code
+   -------------------------------------
+   Return NZ if there is a byte waiting, else Z.
+*/
+CrtInSt()
+{
+	return CrtWait(50);
+}
+
+/* Wait for a byte from the keyboard
+   ---------------------------------
+   Wait 'ms' milliseconds as much. Return NZ if there is a byte waiting,
+   else Z.
+*/
+CrtWait(ms)
+int ms;
+{
+	fd_set fds;
+	struct timeval tv;
+
+	FD_ZERO(&fds); FD_SET(0, &fds);
+
+	tv.tv_sec = 0; tv.tv_usec = ms * 1000L;
+
+	return select(1, &fds, NULL, NULL, &tv) > 0;
+}
+
+/* Check if there is a key waiting
+   -------------------------------
+   Return NZ if there is a key, else Z. Used to skip screen updates while
+   the user is typing ahead.
+
+   int CrtStat(void)
+*/
+CrtStat()
+{
+	return CrtWait(0);
+}
+
+/* Clear screen and send cursor to 0,0
+   -----------------------------------
+   void CrtClear(void)
+*/
+CrtClear()
+{
+	CrtOut(27); putstr("[1;1H"); /* Cursor to 0,0 */
+	CrtOut(27); putstr("[2J");   /* Clear CRT */
+}
+
+/* Locate the cursor (HOME is 0,0)
+   -------------------------------
+   void CrtLocate(int row, int col)
+*/
+CrtLocate(row, col)
+int row, col;
+{
+	CrtOut(27); CrtOut('[');
+	putint("%d", row + 1); CrtOut(';');
+	putint("%d", col + 1); CrtOut('H');
+}
+
+/* Erase line and cursor to row,0
+   ------------------------------
+   void CrtClearLine(int row)
+*/
+CrtClearLine(row)
+int row;
+{
+	CrtLocate(row, 0); CrtClearEol();
+}
+
+/* Erase from the cursor to the end of the line
+   --------------------------------------------
+*/
+CrtClearEol()
+{
+	CrtOut(27); putstr("[K");
+}
+
+/* Turn on / off reverse video
+   ---------------------------
+*/
+CrtReverse(on)
+int on;
+{
+	CrtOut(27); CrtOut('['); CrtOut(on ? '7' : '0'); CrtOut('m');
+}
+
+/* Insert a blank line, the following lines go down
+   -------------------------------------------------
+*/
+CrtInsLine(row)
+int row;
+{
+	CrtLocate(row, 0);
+	CrtOut(27); CrtOut('['); CrtOut('L');
+}
+
+/* Delete a line, the following lines go up
+   ----------------------------------------
+*/
+CrtDelLine(row)
+int row;
+{
+	CrtLocate(row, 0);
+	CrtOut(27); CrtOut('['); CrtOut('M');
+}
+
@@ -35,51 +35,161 @@
 				  Check in MacroGetRaw() for illegal characters.
 	18 Nov 2021 : Added {AutoIndent}, {AutoList}.
 	20 Nov 2021 : Added MatchSym().
+	17 Oct 2026 : Compile the macro files once and run them from memory. Added MacroCompile(),
+	              MacroLoad(), MacroForget(), MacroText(), MacroEmit(), MacroSymbol().
+	              Removed raw mode, InsertFile() does that job now.
+	17 Oct 2026 : Nothing is printed while a macro runs. MacroStop() prints all the screen again.
+	17 Oct 2026 : Up to MAC_REP_MAX repeats of keys, forced with ForceRep().
+	17 Oct 2026 : MacroStop() prints nothing in batch mode.
+	17 Oct 2026 : MacroGetRaw() skips CR and stops at CPM_EOF under OS_POSIX.
+	17 Oct 2026 : MacroStop() prints only the changes on the screen.
+
+	Notes:
+
+	A macro file is compiled into a stream of commands, and kept in a cache
+	of MAC_CACHE entries, by filename. Each entry is a single memory block:
+
+	[filename] [ZERO] [commands...] [MC_END]
+
+	The commands are:
+
+	MC_TEXT   [length] [characters...] : up to FORCED_MAX characters
+	MC_KEY    [key - K_UP] [repeats]   : ie {up:12}, repeats are 2 bytes
+	MC_FILE   [repeats]                : {filename}
+	MC_INDENT [value]                  : {autoindent}
+	MC_LIST   [value]                  : {autolist}
+	MC_END                             : end of macro
+
+	Comments are dropped by the compiler. The file is read twice: first to
+	get the size of the commands, then to store them.
+
+	Saving a file with the same name of a compiled macro removes it from the
+	cache -- see MacroForget().
 */
 
 /* Run a macro from file
    ---------------------
    Returns NZ on error.
 */
-MacroRunFile(fname, raw)
+MacroRunFile(fname)
 char *fname;
-int raw;
 {
-	if(!(mac_fp = fopen(fname, "r")))
+	int i;
+
+	/* Look for the macro in the cache, else compile it */
+	for(i = 0; i < MAC_CACHE; ++i)
+	{
+		if(mac_cache[i] && MatchStr(mac_cache[i], fname))
+		{
+			break;
+		}
+	}
+
+	if(i == MAC_CACHE && (i = MacroLoad(fname)) == -1)
 	{
-		ErrLineOpen();
-		
 		return -1;
 	}
-	
-	mac_raw = raw;
-	
+
+	/* The commands follow the filename */
+	mac_pc = mac_cache[i] + strlen(mac_cache[i]) + 1;
+
 	/* Reset auto-indentation and auto-list */
 	mac_indent = cf_indent;
 	mac_list = cf_list;
 	
 	cf_indent = cf_list = 0;
+
+	/* Print nothing until the macro ends */
+	sh_hold = 1;
 	
 	return 0;
 }
 
-/* Run a macro from string
-   -----------------------
+/* Compile a macro file into the cache
+   -----------------------------------
+   Returns the cache entry, or -1 on error.
 */
-/*
-MacroRunStr(s)
-char *s;
+MacroLoad(fname)
+char *fname;
 {
-	mac_str = s;
+	char *p;
+	int i, len, size;
+
+	/* Get the size of the commands */
+	mac_code = NULL;
+
+	if(MacroCompile(fname))
+	{
+		return -1;
+	}
+
+	size = mac_len;
+
+	if(!(p = AllocMem((len = strlen(fname) + 1) + size)))
+	{
+		return -1;
+	}
+
+	/* Store them -- the file can't grow between the two passes */
+	mac_code = strcpy(p, fname) + len;
+	mac_max = size;
+
+	if(MacroCompile(fname) || mac_len != size)
+	{
+		if(mac_len != size)
+		{
+			ErrLine("Bad macro");
+		}
+
+		free(p);
+
+		return -1;
+	}
+
+	/* Replace the oldest entry */
+	i = mac_next;
+
+	if(++mac_next == MAC_CACHE)
+	{
+		mac_next = 0;
+	}
+
+	if(mac_cache[i])
+	{
+		free(mac_cache[i]);
+	}
+
+	mac_cache[i] = p;
+
+	return i;
 }
+
+/* Remove a macro from the cache
+   -----------------------------
+   Used when a file is saved, as it can be a macro file.
 */
+MacroForget(fname)
+char *fname;
+{
+	int i;
+
+	for(i = 0; i < MAC_CACHE; ++i)
+	{
+		if(mac_cache[i] && MatchStr(mac_cache[i], fname))
+		{
+			free(mac_cache[i]);
+
+			mac_cache[i] = NULL;
+		}
+	}
+}
 
 /* Tell if a macro is running
    --------------------------
 */
 MacroRunning()
 {
-	return mac_fp != NULL /* || mac_str != NULL */;
+	return mac_pc != NULL;
 }
 
 /* Stop a macro
@@ -87,70 +197,71 @@ MacroRunning()
 */
 MacroStop()
 {
-	if(mac_fp)
-	{
-		fclose(mac_fp);
-	}
-
-	mac_fp = /*mac_str =*/ NULL;
+	mac_pc = NULL;
 	
 	/* Restore auto-indentation and auto-list */
 	cf_indent = mac_indent;
 	cf_list = mac_list;
 
+	/* Print the changes, all at once, but in batch mode. The screen
+	   is not printed again: the menus, etc. reset the shadow screen
+	   and the information fields if they print over them. */
+#if OPT_BATCH
+
+	if(!bt_mode)
+	{
+		sh_hold = 0;
+
+		RefreshScreen();
+	}
+
+#else
+
+	sh_hold = 0;
+
+	RefreshScreen();
+
+#endif
+
 	/* Flag end of input */
 	ForceCh('\0');
 }
 
-/* Read raw character from macro input
-   -----------------------------------
+/* Read raw character from macro file
+   ----------------------------------
+   Returns ZERO on end of file.
 */
 MacroGetRaw()
 {
 	int ch;
 
-	if(mac_fp)
-	{
-		if(mac_raw)
-		{
-			/* Raw mode - translate some control chars. */
-			switch(ch = fgetc(mac_fp))
-			{
-				case '\n' : ch = K_CR; break;
-				case '\t' : ch = ' '; break;
-			}
-		}
-		else
-		{
-			/* Normal mode: ignore new-lines */
-			while((ch = fgetc(mac_fp)) == '\n')
-				;
-		}
+#ifdef OS_POSIX
 
-		if(ch != EOF)
-		{
-			/* Translate control chars. */
-			if(ch < 32 || ch == 127)
-			{
-				ch = '?';
-			}
-			
-			return ch;
-		}
+	/* Ignore new-lines, also CR + LF ones, and stop at the CP/M end of file */
+	while((ch = fgetc(mac_fp)) == '\n' || ch == '\r')
+		;
 
-		MacroStop();
-	}
-	/*
-	else if(mac_str)
+	if(ch == CPM_EOF)
+		ch = EOF;
+
+#else
+
+	/* Ignore new-lines */
+	while((ch = fgetc(mac_fp)) == '\n')
+		;
+
+#endif
+
+	if(ch != EOF)
 	{
-		if(*mac_str)
+		/* Translate control chars. */
+		if(ch < 32 || ch == 127)
 		{
-			return *mac_str++;
+			ch = '?';
 		}
-
-		MacroStop();
+		
+		return ch;
 	}
-	*/
 
 	/* No character available */
 	return '\0';
@@ -174,169 +285,288 @@ char *s;
 	return MatchStr(mac_sym, s);
 }
 
-/* Process a macro input unit
-   --------------------------
+/* Compile a macro file
+   --------------------
+   Store the commands in mac_code, or only count them in mac_len if it's
+   NULL. Returns NZ on error.
 */
-MacroGet()
+MacroCompile(fname)
+char *fname;
 {
-	int i, n, ch;
+	int ch, err;
+
+	if(!(mac_fp = fopen(fname, "r")))
+	{
+		ErrLineOpen();
+		
+		return -1;
+	}
 
-	/* Continue if there is a character available */
-	if((ch = MacroGetRaw()))
+	mac_len = mac_run = err = 0;
+
+	while(!err && (ch = MacroGetRaw()))
 	{
-		/* Return character if raw mode */
-		if(mac_raw)
+		/* Symbol like {up} */
+		if(ch == MAC_START)
 		{
-			ForceCh(ch);
-			
-			return;
+			if((err = MacroSymbol()))
+			{
+				/* Error: symbol name not found, bad formed, too large, bad # of repeats */
+				ErrLine("Bad symbol");
+			}
 		}
-		
-		/* Return character if it's not the start of a symbol */
-		if(ch != MAC_START)
+
+		/* Escaped character */
+		else if(ch == MAC_ESCAPE)
 		{
-			/* Check for escaped characters */
-			if(ch != MAC_ESCAPE)
+			if((ch = MacroGetRaw()))
 			{
-				ForceCh(ch);
+				MacroText(ch);
 			}
 			else
 			{
-				if((ch = MacroGetRaw()))
-				{
-					ForceCh(ch);
-				}
-				else
-				{
-					/* Error: missing escaped character */
-					ErrLine("Bad escape sequence");
+				/* Error: missing escaped character */
+				ErrLine("Bad escape sequence");
 
-					MacroStop();
-				}
+				err = -1;
 			}
+		}
 
-			return;
+		/* Character */
+		else
+		{
+			MacroText(ch);
 		}
+	}
+
+	fclose(mac_fp);
 
-		/* Get symbol name like {up} or {up:12} --> "up" */
-		for(i = 0; MacroIsCmdChar(ch = MacroGetRaw()) && i < MAC_SYM_MAX; ++i)
+	MacroEmit(MC_END);
+
+	return err;
+}
+
+/* Compile a symbol
+   ----------------
+   The MAC_START character has been read. Returns NZ on error.
+*/
+MacroSymbol()
+{
+	int i, n, ch;
+
+	/* Get symbol name like {up} or {up:12} --> "up" */
+	for(i = 0; MacroIsCmdChar(ch = MacroGetRaw()) && i < MAC_SYM_MAX; ++i)
+	{
+		mac_sym[i] = tolower(ch);
+	}
+
+	if(!i)
+	{
+		return -1;
+	}
+
+	/* End of symbol name */
+	mac_sym[i] = '\0';
+
+	/* Get # of repeats if any - ie: {up:12} --> 12 */
+	if(ch == MAC_SEP)
+	{
+		n = 0;
+
+		while(isdigit(ch = MacroGetRaw()))
 		{
-			mac_sym[i] = tolower(ch);
+			if(n > MAC_REP_MAX / 10)
+			{
+				return -1;
+			}
+
+			n = n * 10 + ch - '0';
 		}
 
-		if(i)
+		if(n > MAC_REP_MAX)
 		{
-			/* End of symbol name */
-			mac_sym[i] = '\0';
+			return -1;
+		}
+	}
+	else
+	{
+		n = 1;
+	}
 
-			/* Get # of repeats if any - ie: {up:12} --> 12 */
-			if(ch == MAC_SEP)
+	/* Check for comments */
+	if(ch == ' ' && MatchSym("#"))
+	{
+		while((ch = MacroGetRaw()))
+		{
+			if(ch == MAC_END)
 			{
-				n = 0;
+				return 0;
+			}
+		}
+
+		return -1;
+	}
+
+	if(ch != MAC_END)
+	{
+		return -1;
+	}
+
+	/* Check for commands */
+	ch = 0;
+
+	if     (MatchSym("up"))         ch = K_UP;
+	else if(MatchSym("down"))       ch = K_DOWN;
+	else if(MatchSym("left"))       ch = K_LEFT;
+	else if(MatchSym("right"))      ch = K_RIGHT;
+	else if(MatchSym("begin"))      ch = K_BEGIN;
+	else if(MatchSym("end"))        ch = K_END;
+	else if(MatchSym("top"))        ch = K_TOP;
+	else if(MatchSym("bottom"))     ch = K_BOTTOM;
+	else if(MatchSym("newline"))    ch = K_CR;
+	else if(MatchSym("indent"))     ch = K_TAB;
+	else if(MatchSym("delright"))   ch = K_RDEL;
+	else if(MatchSym("delleft"))    ch = K_LDEL;
+	else if(MatchSym("cut"))        ch = K_CUT;
+	else if(MatchSym("copy"))       ch = K_COPY;
+	else if(MatchSym("paste"))      ch = K_PASTE;
+	else if(MatchSym("delete"))     ch = K_DELETE;
+	else if(MatchSym("clearclip"))  ch = K_CLRCLP;
+
+#if OPT_BLOCK
+	else if(MatchSym("blockstart")) ch = K_BLK_START;
+	else if(MatchSym("blockend"))   ch = K_BLK_END;
+#endif
+
+	if(ch)
+	{
+		MacroEmit(MC_KEY); MacroEmit(ch - K_UP); MacroEmit(n & 0xFF); MacroEmit(n >> 8);
+	}
 
-				while(isdigit(ch = MacroGetRaw()))
-					n = n * 10 + ch - '0';
+	/* Special commands */
+	else if(MatchSym("filename"))
+	{
+		if(n > FORCED_MAX)
+		{
+			return -1;
+		}
 
-				if(n < 0 || n > FORCED_MAX)
+		MacroEmit(MC_FILE); MacroEmit(n);
+	}
+	else if(MatchSym("autoindent"))
+	{
+		MacroEmit(MC_INDENT); MacroEmit(n ? 1 : 0);
+	}
+	else if(MatchSym("autolist"))
+	{
+		MacroEmit(MC_LIST); MacroEmit(n ? 1 : 0);
+	}
+	else
+	{
+		return -1;
+	}
+
+	/* The next character starts a new MC_TEXT command */
+	mac_run = 0;
+
+	return 0;
+}
+
+/* Compile a character
+   -------------------
+   Consecutive characters are stored in the same MC_TEXT command.
+*/
+MacroText(ch)
+int ch;
+{
+	if(!mac_run || mac_run == FORCED_MAX)
+	{
+		MacroEmit(MC_TEXT);
+
+		mac_lit = mac_len;
+
+		MacroEmit(0);
+
+		mac_run = 0;
+	}
+
+	MacroEmit(ch);
+
+	if(mac_code && mac_lit < mac_max)
+	{
+		mac_code[mac_lit] = mac_run + 1;
+	}
+
+	++mac_run;
+}
+
+/* Store a byte of the compiled macro
+   ----------------------------------
+*/
+MacroEmit(b)
+int b;
+{
+	if(mac_code && mac_len < mac_max)
+	{
+		mac_code[mac_len] = b;
+	}
+
+	++mac_len;
+}
+
+/* Process a macro command
+   -----------------------
+*/
+MacroGet()
+{
+	int n, ch;
+
+	/* Run commands until something is on the forced entry */
+	while(!fe_now)
+	{
+		switch(*mac_pc++)
+		{
+			case MC_TEXT :
+				for(n = *mac_pc++; n; --n)
 				{
-					n = -1;
+					ForceCh(*mac_pc++);
 				}
-			}
-			else
-			{
-				n = 1;
-			}
+				break;
 
-			if(n >= 0)
-			{
-				/* Check for comments */
-				if(ch == ' ')
+			case MC_KEY :
+				ch = K_UP + *mac_pc++;
+				n = *mac_pc++; n |= *mac_pc++ << 8;
+
+				/* The repeats are done by the key -- see ForceRep() */
+				if(n == 1)
 				{
-					if((MatchSym("#")))
-					{
-						while((ch = MacroGetRaw()))
-						{
-							if(ch == MAC_END)
-							{
-								ForceCh('\0');
-
-								return;
-							}
-						}
-					}
+					ForceCh(ch);
 				}
-
-				/* Check for commands */
-				if(ch == MAC_END)
+				else if(n)
 				{
-					/* Do command action */
-					ch = 0;
-
-					if     (MatchSym("up"))         ch = K_UP;
-					else if(MatchSym("down"))       ch = K_DOWN;
-					else if(MatchSym("left"))       ch = K_LEFT;
-					else if(MatchSym("right"))      ch = K_RIGHT;
-					else if(MatchSym("begin"))      ch = K_BEGIN;
-					else if(MatchSym("end"))        ch = K_END;
-					else if(MatchSym("top"))        ch = K_TOP;
-					else if(MatchSym("bottom"))     ch = K_BOTTOM;
-					else if(MatchSym("newline"))    ch = K_CR;
-					else if(MatchSym("indent"))     ch = K_TAB;
-					else if(MatchSym("delright"))   ch = K_RDEL;
-					else if(MatchSym("delleft"))    ch = K_LDEL;
-					else if(MatchSym("cut"))        ch = K_CUT;
-					else if(MatchSym("copy"))       ch = K_COPY;
-					else if(MatchSym("paste"))      ch = K_PASTE;
-					else if(MatchSym("delete"))     ch = K_DELETE;
-					else if(MatchSym("clearclip"))  ch = K_CLRCLP;
-
-#if OPT_BLOCK
-					else if(MatchSym("blockstart")) ch = K_BLK_START;
-					else if(MatchSym("blockend"))   ch = K_BLK_END;
-#endif
+					ForceRep(ch, n);
+				}
+				break;
 
-					if(ch)
-					{
-						while(n--)
-						{
-							if(ForceCh(ch))
-								break;
-						}
-
-						return;
-					}
-
-					/* Special commands */
-					if(MatchSym("filename"))
-					{
-						while(n--)
-							ForceStr(CurrentFile());
-
-						return;
-					}
-					else if(MatchSym("autoindent")) {
-						cf_indent = (n ? 1 : 0);
-						
-						ForceCh('\0');
-						
-						return;
-					}
-					else if(MatchSym("autolist")) {
-						cf_list = (n ? 1 : 0);
-						
-						ForceCh('\0');
-						
-						return;
-					}
+			case MC_FILE :
+				for(n = *mac_pc++; n; --n)
+				{
+					ForceStr(CurrentFile());
 				}
-			}
-		}
+				break;
+
+			case MC_INDENT :
+				cf_indent = *mac_pc++;
+				break;
 
-		/* Error: symbol name not found, bad formed, too large, bad # of repeats */
-		ErrLine("Bad symbol");
+			case MC_LIST :
+				cf_list = *mac_pc++;
+				break;
 
-		MacroStop();
+			default : /* MC_END */
+				MacroStop();
+				return;
+		}
 	}
 }
 
-
\ No newline at end of file
@@ -25,6 +25,33 @@
 	13 Jan 2019 : Added AllocMem().
 	19 Jan 2019 : Added FreeArray().
 	30 Jan 2019 : Added MatchStr().
+	17 Oct 2026 : Added line storage: LineAlloc(), LineFree(), LineFreeBytes(). FreeArray() frees lines.
+	17 Oct 2026 : Line records have a length byte and room to grow. Added LineLen(), LineCap(), LineSetLen().
+	17 Oct 2026 : Added LineRecord(). Swap out lines when there is no memory. Text pointers are even.
+	17 Oct 2026 : LineFree() ignores records of size class 0.
+	17 Oct 2026 : Count calls for the statistics.
+	17 Oct 2026 : LineRecord() keeps less memory free before swapping.
+
+	Notes:
+
+	Text lines are not allocated one by one with malloc(). They are carved
+	from chunks of LA_CHUNK bytes, in records of size classes multiple of
+	LA_GRAN bytes. Each record has a header with its size class and the
+	length of the text, then the text and its ZERO:
+
+	[class] [length] [text...] [ZERO] [room to grow...]
+
+	Lines can be modified in place while their length is not greater than
+	their capacity -- see LineCap(). Call LineSetLen() after that, even if
+	the length is the same: the line is not the same as in the swap file
+	anymore -- see te_swap.c.
+
+	The lines of a file read in place are records of size class 0, without
+	room to grow. They are not freed one by one -- see ReadFile().
+
+	Freed records are kept in a list by size class for later use. When there
+	are no records in use (no text and no clipboard), all the chunks are
+	given back to malloc().
 */
 
 /* Allocate memory
@@ -36,6 +63,12 @@ unsigned int bytes;
 {
 	char *p;
 
+#if OPT_STATS
+
+	++st_now[ST_MEM];
+
+#endif
+
 	if(!(p = malloc(bytes))) {
 		ErrLineMem();
 	}
@@ -43,9 +76,247 @@ unsigned int bytes;
 	return p;
 }
 
-/* Free array
-   ----------
-   Deallocate array memory.
+/* Allocate a text line
+   ---------------------
+   Allocate memory for a line of 'len' characters + ZERO, plus room for
+   'slack' characters more, up to ln_max. Sets the length of the line to
+   'len'. Shows error message on failure. Returns NULL on failure, else a
+   pointer to the text.
+*/
+LineAlloc(len, slack)
+int len, slack;
+{
+	char *p;
+	int cls;
+
+#if OPT_STATS
+
+	++st_now[ST_MEM];
+
+#endif
+
+	/* Capacity */
+	if((slack += len) > ln_max) {
+		slack = (len > ln_max ? len : ln_max);
+	}
+
+	/* Size class for header + text + ZERO */
+	cls = (slack + 2 + LA_GRAN) / LA_GRAN;
+
+#if OPT_SWAP
+
+	/* Swap out lines while there is no memory, but leave some room to
+	   grow the lines array; use all the memory as the last resort */
+	while(!(p = LineRecord(cls, 1))) {
+		if(!SwapOut()) {
+			p = LineRecord(cls, 0);
+
+			break;
+		}
+	}
+
+#else
+
+	p = LineRecord(cls, 0);
+
+#endif
+
+	if(!p) {
+		ErrLineMem();
+
+		return NULL;
+	}
+
+	p[1] = len;
+
+	return p + 2;
+}
+
+/* Get a record for a text line
+   ----------------------------
+   Get a record of size class 'cls' from the free lists or from the chunks.
+   If 'keep' is NZ, a new chunk is taken only if there is memory left to
+   grow the lines array by LP_CHUNK lines. Returns NULL on failure, else
+   a pointer to the record.
+*/
+LineRecord(cls, keep)
+int cls, keep;
+{
+	char *p;
+	int i, *ip;
+
+	/* Try a free record of the same size class, or of a bigger one */
+	for(i = cls; i < LA_CLASSES; ++i) {
+		if((p = la_free[i])) {
+			ip = p + 2; la_free[i] = *ip;
+
+			la_bytes -= i * LA_GRAN;
+
+			++la_used;
+
+			return p;
+		}
+	}
+
+	/* Carve a new record from the current chunk */
+	if(la_end - la_ptr < cls * LA_GRAN) {
+
+		/* Keep what remains in the current chunk */
+		if((i = (la_end - la_ptr) / LA_GRAN)) {
+			*la_ptr = i; ++la_used;
+
+			LineFree(la_ptr + 2);
+		}
+
+		la_ptr = la_end;
+
+		if(keep) {
+			if(!(p = malloc(LA_CHUNK + LP_CHUNK * SIZEOF_PTR))) {
+				return NULL;
+			}
+
+			free(p);
+		}
+
+		/* Get a new chunk, or at least the record if memory is low */
+		if(!(p = malloc(LA_CHUNK))) {
+			if(keep || !(p = malloc(cls * LA_GRAN + SIZEOF_PTR + 1))) {
+				return NULL;
+			}
+
+			la_size += cls * LA_GRAN + SIZEOF_PTR + 1;
+
+			la_end = p + cls * LA_GRAN + SIZEOF_PTR + 1;
+		}
+		else {
+			la_size += LA_CHUNK;
+
+			la_end = p + LA_CHUNK;
+		}
+
+		/* Link the chunk */
+		ip = p; *ip = la_chunks; la_chunks = p;
+
+		/* Text pointers must be even -- see te_swap.c */
+		i = p;
+
+		la_ptr = p + SIZEOF_PTR + (i & 1);
+	}
+
+	p = la_ptr; la_ptr += cls * LA_GRAN;
+
+	p[0] = cls;
+
+	++la_used;
+
+	return p;
+}
+
+/* Free a text line
+   ----------------
+   Deallocate memory from LineAlloc().
+*/
+LineFree(text)
+char *text;
+{
+	char *p;
+	int cls, *ip;
+
+#if OPT_STATS
+
+	++st_now[ST_MEM];
+
+#endif
+
+	p = text - 2;
+
+#if OPT_SWAP
+
+	*p &= ~LA_SWAPPED;
+
+#endif
+
+	/* Nothing to do for lines read in place -- see ReadFile() */
+	if(!(cls = *p)) {
+		return;
+	}
+
+	ip = text; *ip = la_free[cls]; la_free[cls] = p;
+
+	la_bytes += cls * LA_GRAN;
+
+	/* Give back all the chunks if there are no lines in use */
+	if(!--la_used) {
+		while((p = la_chunks)) {
+			ip = p; la_chunks = *ip;
+
+			free(p);
+		}
+
+		for(cls = 0; cls < LA_CLASSES; ++cls) {
+			la_free[cls] = NULL;
+		}
+
+		la_ptr = la_end = NULL;
+		la_bytes = la_size = 0;
+	}
+}
+
+/* Return length of a text line
+   -----------------------------
+*/
+LineLen(text)
+unsigned char *text;
+{
+	return text[-1];
+}
+
+/* Set length of a text line
+   -------------------------
+*/
+LineSetLen(text, len)
+char *text; int len;
+{
+	text[-1] = len;
+
+#if OPT_SWAP
+
+	/* It's not the same as in the swap file, if any */
+	text[-2] &= ~LA_SWAPPED;
+
+#endif
+}
+
+/* Return capacity of a text line
+   ------------------------------
+   This is the max. length the line can have without reallocation.
+*/
+LineCap(text)
+unsigned char *text;
+{
+#if OPT_SWAP
+
+	return (text[-2] & ~LA_SWAPPED) * LA_GRAN - 3;
+
+#else
+
+	return text[-2] * LA_GRAN - 3;
+
+#endif
+}
+
+/* Return free bytes in line storage
+   ---------------------------------
+   These are the bytes that can be reused by LineAlloc() without calling malloc().
+*/
+LineFreeBytes()
+{
+	return la_bytes + (la_end - la_ptr);
+}
+
+/* Free array of lines
+   -------------------
+   Deallocate lines memory, and array memory if 'flag' is NZ.
 */
 FreeArray(arr, count, flag)
 int *arr, count, flag;
@@ -54,7 +325,7 @@ int *arr, count, flag;
 
 	for(i = 0; i < count; ++i) {
 		if(arr[i]) {
-			free(arr[i]);
+			LineFree(arr[i]);
 
 			arr[i] = NULL;
 		}
@@ -80,4 +351,3 @@ char *s1, *s2;
 
 #endif
 
-
\ No newline at end of file
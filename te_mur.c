@@ -47,6 +47,8 @@
 	11 May 2021 : Remove CRT configuration values.
 	30 Jun 2021 : Added CRT_DEF_ROWS, CRT_DEF_COLS.
 	06 Jul 2021 : Optimize CrtOut().
+	17 Oct 2026 : Added CrtStat().
+	17 Oct 2026 : Set CRT_LOC_COST.
 
 	Notes:
 
@@ -74,6 +76,11 @@
 #define OPT_BLOCK 1  /* Block selection */
 #define OPT_MACRO 1  /* Enable macros */
 
+/* Definitions
+   -----------
+*/
+#define CRT_LOC_COST 7   /* ESC [ row ; col H */
+
 /* Include main code
    -----------------
 */
@@ -145,6 +152,21 @@ CrtIn:
 	ret
 #endasm
 
+/* Check if there is a key waiting
+   -------------------------------
+   Return NZ if there is a key, else Z. Used to skip screen updates while
+   the user is typing ahead.
+
+   int CrtStat(void)
+*/
+#asm
+CrtStat:
+	call BiosConst
+	ld h,0
+	ld l,a
+	ret
+#endasm
+
 /* Clear screen and send cursor to 0,0
    -----------------------------------
    void CrtClear(void)
@@ -0,0 +1,194 @@
+/*	te_null.c
+
+	Text editor -- version without CRT, to play back key traces, under CP/M.
+
+	Copyright (c) 2015-2026 Miguel Garcia / FloppySoftware
+
+	This program is free software; you can redistribute it and/or modify it
+	under the terms of the GNU General Public License as published by the
+	Free Software Foundation; either version 2, or (at your option) any
+	later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+	Usage:
+
+	te_null -P trace [filename]
+
+	Compilation:
+
+	cc te_null
+	ccopt te_null
+	zsm te_null
+	hextocom te_null
+
+	Changes:
+
+	17 Oct 2026 : 1st version.
+
+	Notes:
+
+	Nothing is printed: the characters that a VT52-like terminal would
+	receive are only counted, so the playback measures the editor alone.
+
+	There is no keyboard: the editor quits when the trace is over, or at
+	the first key if there is no trace -- see te_trace.c.
+*/
+
+/* Default configuration values
+   ----------------------------
+*/
+#define CRT_DEF_ROWS 25
+#define CRT_DEF_COLS 80
+
+/* Options
+   -------
+   Set to 1 to add the following functionalities, else 0.
+*/
+#define OPT_LWORD 1  /* Go to word on the left */
+#define OPT_RWORD 1  /* Go to word on the right */
+#define OPT_FIND  1  /* Find string */
+#define OPT_GOTO  1  /* Go to line # */
+#define OPT_BLOCK 1  /* Block selection */
+#define OPT_MACRO 1  /* Enable macros */
+#define OPT_TRACE 1  /* Record and play back key traces */
+
+/* Definitions
+   -----------
+*/
+#define CRT_CAN_INS 1    /* Insert and delete lines are available */
+
+/* Include main code
+   -----------------
+*/
+#include "te.c"
+
+/* Setup CRT: Used when the editor starts
+   --------------------------------------
+   void CrtSetup(void)
+*/
+CrtSetup()
+{
+}
+
+/* Reset CRT: Used when the editor exits
+   -------------------------------------
+   void CrtReset(void)
+*/
+CrtReset()
+{
+}
+
+/* Output character to the CRT
+   ---------------------------
+   All program output is done with this function.
+
+   Count the character.
+
+   void CrtOut(int ch)
+*/
+CrtOut(ch)
+int ch;
+{
+	TraceCount(ch == '\n' ? CRT_NL_COST : 1);
+}
+
+/* Input character from the keyboard
+   ---------------------------------
+   All program input is done with this function.
+
+   There is no keyboard: quit.
+
+   int CrtIn(void)
+*/
+CrtIn()
+{
+	TraceQuit();
+}
+
+/* Check if there is a key waiting
+   -------------------------------
+   Return NZ if there is a key, else Z. Used to skip screen updates while
+   the user is typing ahead.
+
+   int CrtStat(void)
+*/
+CrtStat()
+{
+	return 0;
+}
+
+/* Clear screen and send cursor to 0,0
+   -----------------------------------
+   void CrtClear(void)
+*/
+CrtClear()
+{
+	TraceCount(4); /* ESC H ESC J */
+}
+
+/* Locate the cursor (HOME is 0,0)
+   -------------------------------
+   void CrtLocate(int row, int col)
+*/
+CrtLocate(row, col)
+int row, col;
+{
+	TraceCount(CRT_LOC_COST);
+}
+
+/* Erase line and cursor to row,0
+   ------------------------------
+   void CrtClearLine(int row)
+*/
+CrtClearLine(row)
+int row;
+{
+	CrtLocate(row, 0); CrtClearEol();
+}
+
+/* Erase from the cursor to the end of the line
+   --------------------------------------------
+*/
+CrtClearEol()
+{
+	TraceCount(2); /* ESC K */
+}
+
+/* Turn on / off reverse video
+   ---------------------------
+*/
+CrtReverse(on)
+int on;
+{
+	TraceCount(2); /* ESC p / ESC q */
+}
+
+/* Insert a blank line, the following lines go down
+   -------------------------------------------------
+*/
+CrtInsLine(row)
+int row;
+{
+	CrtLocate(row, 0);
+	TraceCount(2); /* ESC L */
+}
+
+/* Delete a line, the following lines go up
+   ----------------------------------------
+*/
+CrtDelLine(row)
+int row;
+{
+	CrtLocate(row, 0);
+	TraceCount(2); /* ESC M */
+}
+
+
\ No newline at end of file
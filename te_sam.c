@@ -32,6 +32,7 @@
 	Changes:
 
 	14 Nov 2021 : 1st version derived from the Amstrad PCW one.
+	17 Oct 2026 : Added CrtStat().
 
 	Notes:
 
@@ -127,6 +128,21 @@ CrtIn:
 	ret
 #endasm
 
+/* Check if there is a key waiting
+   -------------------------------
+   Return NZ if there is a key, else Z. Used to skip screen updates while
+   the user is typing ahead.
+
+   int CrtStat(void)
+*/
+#asm
+CrtStat:
+	call BiosConst
+	ld h,0
+	ld l,a
+	ret
+#endasm
+
 /* Clear screen and send cursor to 0,0
    -----------------------------------
    void CrtClear(void)
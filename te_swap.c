@@ -0,0 +1,318 @@
+/*	te_swap.c
+
+	Text editor.
+
+	Swap file.
+
+	Copyright (c) 2015-2026 Miguel Garcia / FloppySoftware
+
+	This program is free software; you can redistribute it and/or modify it
+	under the terms of the GNU General Public License as published by the
+	Free Software Foundation; either version 2, or (at your option) any
+	later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+	Changes:
+
+	17 Oct 2026 : Added SwapOpen(), SwapClose(), SwapReset(), SwapOut(), SwapIn(), SwapPeek().
+	17 Oct 2026 : Don't swap out lines read in place.
+	17 Oct 2026 : SwapIn() returns NULL if there is no memory.
+	17 Oct 2026 : Don't try to open the swap file again after a failure.
+
+	Notes:
+
+	When there is no memory for a new line, LineAlloc() calls SwapOut() to
+	write some lines into the swap file, and to free their memory. The swap
+	file is created on the current drive the first time it is needed, and it
+	is removed on exit. If it can't be created, no more lines are swapped
+	out until exit.
+
+	A swapped out line has an odd value in the lines array: its position in
+	the swap file, in units of SW_GRAN bytes, shifted one bit to the left and
+	plus one. The text pointers from LineAlloc() are always even.
+
+	Each line is written as its length byte and its text, starting in a new
+	unit. The file is only appended to: the space of the lines read back or
+	deleted is not reused until another file is loaded -- see SwapReset().
+
+	GetLine() reads back a swapped out line when it is needed. The line
+	keeps its position in the swap file (see LA_SWAPPED), so it is not
+	written again while it is not modified.
+
+	The lines around the cursor, and the last line read with GetLine(), are
+	never swapped out, so the pointers in use by the editor stay valid.
+*/
+
+/* Open the swap file
+   ------------------
+   Return NZ on success, else Z.
+*/
+SwapOpen()
+{
+	int i;
+	char *s;
+
+	s = SW_FCBNAME;
+
+	for(i = 0; i < 36; ++i) {
+		sw_fcb[i] = (i && i < 12 ? s[i - 1] : 0);
+	}
+
+	/* Delete the old one, and make a new one */
+	bdos_a(0x13, sw_fcb);
+
+	if(bdos_a(0x16, sw_fcb) == 0xFF) {
+		ErrLineSwap();
+
+		/* Don't try again */
+		sw_open = -1;
+
+		return 0;
+	}
+
+	sw_open = 1;
+
+	SwapReset();
+
+	return 1;
+}
+
+/* Close and remove the swap file
+   ------------------------------
+*/
+SwapClose()
+{
+	if(sw_open > 0) {
+		bdos_a(0x10, sw_fcb);
+		bdos_a(0x13, sw_fcb);
+
+		sw_open = 0;
+	}
+}
+
+/* Forget the swap file contents
+   -----------------------------
+   Called when there are no lines in the array.
+*/
+SwapReset()
+{
+	sw_units = sw_dirty = sw_clock = 0;
+	sw_recno = -1;
+}
+
+/* Read or write a record of the swap file
+   ---------------------------------------
+   Return the BDOS error code.
+*/
+SwapRW(rec, fn)
+int rec, fn;
+{
+	sw_fcb[33] = rec;
+	sw_fcb[34] = rec >> 8;
+	sw_fcb[35] = 0;
+
+	bdos_a(0x1A, sw_rec);
+
+	return bdos_a(fn, sw_fcb);
+}
+
+/* Read a record of the swap file into the buffer
+   ----------------------------------------------
+   The buffer is written before, if it was modified. Return NZ on success,
+   else Z.
+*/
+SwapRecord(rec)
+int rec;
+{
+	int err;
+
+	if(sw_dirty) {
+		if(SwapRW(sw_recno, 0x22)) {
+			ErrLineSwap();
+
+			return 0;
+		}
+
+		sw_dirty = 0;
+	}
+
+	/* Records past the end of the file are not an error */
+	if((err = SwapRW(rec, 0x21)) && err != 1 && err != 4) {
+		ErrLineSwap();
+
+		return 0;
+	}
+
+	sw_recno = rec;
+
+	return 1;
+}
+
+/* Read or write bytes from / to the swap file
+   -------------------------------------------
+   Return NZ on success, else Z.
+*/
+SwapIO(unit, buf, len, wr)
+unsigned int unit; char *buf; int len, wr;
+{
+	int rec, pos;
+
+	rec = unit / (128 / SW_GRAN);
+	pos = unit % (128 / SW_GRAN) * SW_GRAN;
+
+	while(len--) {
+		if(pos == 128) {
+			++rec; pos = 0;
+		}
+
+		if(rec != sw_recno) {
+			if(!SwapRecord(rec)) {
+				return 0;
+			}
+		}
+
+		if(wr) {
+			sw_rec[pos++] = *buf++; sw_dirty = 1;
+		}
+		else {
+			*buf++ = sw_rec[pos++];
+		}
+	}
+
+	return 1;
+}
+
+/* Swap out some lines
+   -------------------
+   Return the # of lines swapped out.
+*/
+SwapOut()
+{
+	int n, k, i, len, lo, hi;
+	unsigned int unit;
+	unsigned char *p;
+	WORD w;
+
+	if(sw_open < 0) {
+		return 0;
+	}
+
+	if(!sw_open) {
+		if(!SwapOpen()) {
+			return 0;
+		}
+	}
+
+	/* Keep the lines around the cursor */
+	lo = lp_cur - box_rows;
+	hi = lp_cur + box_rows;
+
+	for(n = k = 0; n < SW_BATCH && k < lp_now; ++k) {
+		if(++sw_clock >= lp_now) {
+			sw_clock = 0;
+		}
+
+		if((sw_clock >= lo && sw_clock <= hi) || sw_clock == sw_last) {
+			continue;
+		}
+
+		if((w = lp_arr[i = GapIndex(sw_clock)]) & 1) {
+			continue;
+		}
+
+		/* Lines read in place can't be freed -- see ReadFile() */
+		if(!((p = w)[-2] & ~LA_SWAPPED)) {
+			continue;
+		}
+
+		len = LineLen(p);
+
+		if(p[-2] & LA_SWAPPED) {
+			/* Not modified since it was read, it's already there */
+			unit = p[len + 1] | (p[len + 2] << 8);
+		}
+		else {
+			/* Length byte + text */
+			if((unit = sw_units) + (len + SW_GRAN) / SW_GRAN > 0x7FFF) {
+				break;
+			}
+
+			if(!SwapIO(unit, p - 1, len + 1, 1)) {
+				break;
+			}
+
+			sw_units += (len + SW_GRAN) / SW_GRAN;
+		}
+
+		LineFree(p);
+
+		lp_arr[i] = (unit << 1) | 1;
+
+		++n;
+	}
+
+	return n;
+}
+
+/* Return the text of a swapped out line
+   -------------------------------------
+   The text is in a buffer, and it's valid until next call. Its length
+   can be read with LineLen().
+*/
+SwapPeek(w)
+WORD w;
+{
+	unsigned int unit;
+
+	unit = w >> 1;
+
+	if(!SwapIO(unit, sw_dat, 1, 0) || !SwapIO(unit, sw_dat, sw_dat[0] + 1, 0)) {
+		sw_dat[0] = 0;
+	}
+
+	sw_dat[sw_dat[0] + 1] = '\0';
+
+	return sw_dat + 1;
+}
+
+/* Read back a swapped out line
+   ----------------------------
+   Argument is its index in the lines array. Return its text, or NULL if
+   there is no memory for it -- the line stays swapped out.
+*/
+SwapIn(i)
+int i;
+{
+	unsigned char *p, *s;
+	unsigned int unit;
+	int len;
+
+	unit = lp_arr[i] >> 1;
+
+	len = LineLen((s = SwapPeek(lp_arr[i])));
+
+	if(!(p = LineAlloc(len, 2))) {
+		return NULL;
+	}
+
+	strcpy(p, s);
+
+	/* Remember its position in the swap file, after the ZERO */
+	if(LineCap(p) >= len + 2) {
+		p[len + 1] = unit;
+		p[len + 2] = unit >> 8;
+
+		p[-2] |= LA_SWAPPED;
+	}
+
+	return (lp_arr[i] = p);
+}
+
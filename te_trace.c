@@ -0,0 +1,253 @@
+/*	te_trace.c
+
+	Text editor.
+
+	Key traces.
+
+	Copyright (c) 2015-2026 Miguel Garcia / FloppySoftware
+
+	This program is free software; you can redistribute it and/or modify it
+	under the terms of the GNU General Public License as published by the
+	Free Software Foundation; either version 2, or (at your option) any
+	later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+	Changes:
+
+	17 Oct 2026 : Added TraceArgs(), TraceKey(), TraceCount(), TraceEnd(), TraceQuit(), TraceReport(),
+	              TraceTime(), TracePuts(), TraceNum().
+	17 Oct 2026 : The checksum is 16 bits wide on any system.
+
+	Notes:
+
+	With OPT_TRACE, getchr() is TraceKey(), and the command line can be:
+
+	te -R trace [filename] : record each key code from GetKey() in the trace file.
+	te -P trace [filename] : play the trace file back instead of reading the keyboard.
+
+	A trace file is the key codes, as two bytes each, low byte first. The
+	codes are the ones returned by GetKey(), so a trace can be played back
+	by any adaptation, whatever its keyboard.
+
+	When the playback is over, te prints the # of keys, the characters sent
+	to the CRT (counted by the adaptation, with TraceCount()), the time in
+	seconds (CP/M 3 only), and a checksum of the text. If the trace ends
+	while a line is being edited, the changes to that line are not counted
+	in the checksum.
+
+	The te_null adaptation doesn't print anything, so it measures the
+	editor alone.
+*/
+
+/* Check the command line for a trace option
+   -----------------------------------------
+   Return NZ if 'opt' is a trace option, else Z.
+*/
+TraceArgs(opt, fname)
+char *opt, *fname;
+{
+	if(*opt != '-' || opt[2]) {
+		return 0;
+	}
+
+	switch(toupper(opt[1])) {
+		case 'R' : tr_mode = TR_RECORD; break;
+		case 'P' : tr_mode = TR_PLAY;   break;
+		default  : return 0;
+	}
+
+	if(!(tr_fp = fopen(fname, tr_mode == TR_PLAY ? "rb" : "wb"))) {
+		tr_mode = 0;
+
+		ErrLineOpen();
+	}
+	else if(tr_mode == TR_PLAY) {
+		tr_time = TraceTime();
+	}
+
+	return 1;
+}
+
+/* Return key from the trace file, or keyboard
+   -------------------------------------------
+   It's getchr() when OPT_TRACE is 1.
+*/
+TraceKey()
+{
+	int lo, hi, key;
+
+	if(tr_mode == TR_PLAY) {
+		if((lo = fgetc(tr_fp)) == EOF || (hi = fgetc(tr_fp)) == EOF) {
+			TraceQuit();
+		}
+
+		key = (hi << 8) | lo;
+	}
+	else {
+		key = GetKey();
+
+		if(tr_mode == TR_RECORD) {
+			fputc(key & 0xFF, tr_fp);
+			fputc((key >> 8) & 0xFF, tr_fp);
+		}
+	}
+
+	++tr_keys;
+
+	return key;
+}
+
+/* Count characters sent to the CRT
+   --------------------------------
+   Called by the adaptation.
+*/
+TraceCount(n)
+int n;
+{
+	if((tr_out += n) >= 10000) {
+		tr_out -= 10000; ++tr_out10k;
+	}
+}
+
+/* Close the trace file, and get the checksum of the text
+   ------------------------------------------------------
+   Called on exit, before the swap file is removed.
+*/
+TraceEnd()
+{
+	int i;
+	unsigned char *p;
+
+	if(tr_mode) {
+		fclose(tr_fp);
+	}
+
+	/* Rotate left and add each character, and the line ends: in 16
+	   bits, even if the int type is wider */
+	tr_sum = 0;
+
+	for(i = 0; i < lp_now; ++i) {
+		for(p = PeekLine(i); *p; ++p) {
+			tr_sum = (((tr_sum << 1) | (tr_sum >> 15)) + *p) & 0xFFFF;
+		}
+
+		tr_sum = (((tr_sum << 1) | (tr_sum >> 15)) + '\n') & 0xFFFF;
+	}
+}
+
+/* Quit when the trace is over
+   ---------------------------
+   Like the end of main(), but from anywhere.
+*/
+TraceQuit()
+{
+	TraceEnd();
+
+#if OPT_SWAP
+
+	SwapClose();
+
+#endif
+
+	CrtClear();
+	CrtFlush();
+	CrtReset();
+
+	TraceReport();
+
+	exit(0);
+}
+
+/* Print the results of the playback
+   ---------------------------------
+   The CRT is already reset, so print them with the BDOS.
+*/
+TraceReport()
+{
+	unsigned int t;
+
+	if(tr_mode != TR_PLAY) {
+		return;
+	}
+
+	TracePuts("Keys: ");  TraceNum(tr_keys);
+
+	TracePuts("\r\nOutput: ");
+
+	if(tr_out10k) {
+		TraceNum(tr_out10k);
+		TraceNum(tr_out / 1000);
+		TraceNum(tr_out / 100 % 10);
+		TraceNum(tr_out / 10 % 10);
+		TraceNum(tr_out % 10);
+	}
+	else {
+		TraceNum(tr_out);
+	}
+
+	TracePuts("\r\nTime: ");
+
+	if(cpm_ver >= 0x30) {
+		t = TraceTime();
+
+		TraceNum(t >= tr_time ? t - tr_time : t + 3600 - tr_time);
+	}
+	else {
+		TracePuts("?");
+	}
+
+	TracePuts("\r\nChecksum: "); TraceNum(tr_sum);
+
+	TracePuts("\r\n");
+}
+
+/* Return seconds in the hour from the CP/M 3 clock
+   -------------------------------------------------
+   The BDOS returns the minutes and seconds in BCD.
+*/
+TraceTime()
+{
+	unsigned char dat[4];
+	int sec;
+
+	if(cpm_ver < 0x30) {
+		return 0;
+	}
+
+	sec = bdos_a(0x69, dat);
+
+	return ((dat[3] >> 4) * 10 + (dat[3] & 0x0F)) * 60 + (sec >> 4) * 10 + (sec & 0x0F);
+}
+
+/* Print string with the BDOS
+   --------------------------
+*/
+TracePuts(s)
+char *s;
+{
+	while(*s) {
+		bdos_a(0x02, *s++);
+	}
+}
+
+/* Print unsigned number with the BDOS
+   -----------------------------------
+*/
+TraceNum(n)
+unsigned int n;
+{
+	if(n > 9) {
+		TraceNum(n / 10);
+	}
+
+	bdos_a(0x02, '0' + n % 10);
+}
+
@@ -42,6 +42,25 @@
 	05 Jul 2021 : Support for OPT_Z80.
 	25 Sep 2021 : Added SysLineEdit(). Fix URLs.
 	01 Nov 2021 : Added menu option when macros are enabled: insert file.
+	17 Oct 2026 : Use GetLine().
+	17 Oct 2026 : The size of the lines array is printed in Loop(). Print the last digits of line numbers only.
+	17 Oct 2026 : Added shadow screen: RefreshRow(), PrintSpan(), ShadowReset(). Refresh() and RefreshBlock() print the changes only.
+	17 Oct 2026 : Added buffered output: CrtOut(), CrtFlush().
+	17 Oct 2026 : Added ScrollBoxDown(), ScrollBoxUp().
+	17 Oct 2026 : Refresh() and RefreshBlock() leave rows for later while there are keys waiting.
+	17 Oct 2026 : Added putnum(), ShowField().
+	17 Oct 2026 : RefreshBlock() prints only the rows whose selection changed. RefreshRow() does nothing on unchanged selected rows.
+	17 Oct 2026 : Added Locate(), LocateAt(). Use them in RefreshRow() and ShowField().
+	17 Oct 2026 : Added statistics: StatOut(), StatKey(), MenuStats().
+	17 Oct 2026 : Added ShowInfo(), SetScreenSize(), ResizeScreen(). Don't write into string constants.
+	17 Oct 2026 : MenuInsert() uses InsertFile() instead of a macro, and it's always available.
+	17 Oct 2026 : Added RedrawScreen(). Print nothing in the editor box and information line while sh_hold is set.
+	17 Oct 2026 : Print nothing on the system line and filename field in batch mode.
+	17 Oct 2026 : Added RefreshScreen().
+	17 Oct 2026 : Added StatLoc(), StatNum(). Count all the cursor moves. The totals don't wrap.
+	17 Oct 2026 : MenuInsert() reads the rest of the current file before counting the inserted lines.
+	17 Oct 2026 : ShowFilename() clips the filename before the information layout.
+	17 Oct 2026 : MenuStats() shows the free bytes in line storage.
 */
 
 /* Read character from keyboard
@@ -54,6 +73,102 @@ getchr()
 }
 ******************************* */
 
+#if CRT_OUT_BUF
+
+/* Output character to the CRT
+   ---------------------------
+   All program output is done with this function, when the adaptation
+   sets CRT_OUT_BUF to 1. The characters are stored in a buffer, and
+   written by CrtFlush() with the adaptation function CrtWrite().
+*/
+CrtOut(ch)
+int ch;
+{
+	if(co_len == CRT_OUT_SIZ)
+		CrtFlush();
+
+	co_buf[co_len++] = ch;
+}
+
+#endif
+
+/* Write the output buffer to the CRT
+   ----------------------------------
+   Call it before waiting for the user. Does nothing if CRT_OUT_BUF is 0.
+*/
+CrtFlush()
+{
+#if CRT_OUT_BUF
+
+	if(co_len)
+	{
+		CrtWrite(co_buf, co_len);
+
+		co_len = 0;
+	}
+
+#endif
+}
+
+#if OPT_STATS
+
+/* Print character on screen, and count it
+   ---------------------------------------
+   It's putchr() when OPT_STATS is 1. The escape sequences sent by the
+   adaptation are not counted: CrtLocate() calls are counted apart -- see
+   StatLoc().
+*/
+StatOut(ch)
+int ch;
+{
+	++st_now[ST_OUT];
+
+	CrtOut(ch);
+}
+
+/* Move the cursor, and count it
+   ------------------------------
+   It's MoveTo() when OPT_STATS is 1. Call it instead of CrtLocate().
+*/
+StatLoc(row, col)
+int row, col;
+{
+	++st_now[ST_LOC];
+
+	CrtLocate(row, col);
+}
+
+/* Count a key
+   -----------
+   Call it before reading each key in the editor: the counters have the
+   work done for the previous one.
+*/
+StatKey()
+{
+	int i;
+
+	for(i = 0; i < ST_MAX; ++i) {
+		st_last[i] = st_now[i];
+
+		/* The totals stop at the max. value -- see StatNum() */
+		if((st_tot[i] += st_now[i]) < st_now[i]) {
+			st_tot[i] = -1;
+		}
+
+		if(st_top[i] < st_now[i]) {
+			st_top[i] = st_now[i];
+		}
+
+		st_now[i] = 0;
+	}
+
+	if(st_keys != -1) {
+		++st_keys;
+	}
+}
+
+#endif
+
 /* Print character on screen
    -------------------------
 */
@@ -170,6 +285,114 @@ char *format; int value;
 	putstr(r);
 }
 
+/* Print number on screen, with leading zeros
+   -------------------------------------------
+   In 'width' digits (max. 5). If the number is bigger, print the last digits.
+*/
+putnum(value, width)
+unsigned int value; int width;
+{
+	char r[6]; /* 12345 + ZERO */
+	int i;
+
+	r[width] = '\0';
+
+	for(i = width; i; value /= 10) {
+		r[--i] = '0' + value % 10;
+	}
+
+	putstr(r);
+}
+
+/* Move the cursor
+   ---------------
+   If the cursor position is known, choose the cheapest way to go to 'row',
+   'col': CR, '\n', BS, printing again the characters that are under the
+   cursor in the editor box (as the shadow screen says), or CrtLocate().
+
+   The position is unknown after the move, because the caller is going
+   to print something: call LocateAt() when it's known again.
+*/
+Locate(row, col)
+int row, col;
+{
+	int how, cost, r, len;
+	char *p;
+
+	if(sh_hold)
+	{
+		cr_row = -1; return;
+	}
+
+	/* 0 = CrtLocate(), 1 = print, 2 = BS, 3 = CR + print, 4 = '\n' + print */
+	how = 0; cost = CRT_LOC_COST;
+
+	if(cr_row >= 0)
+	{
+		/* Characters under the cursor: not on the line being edited,
+		   nor in reverse */
+		p = NULL; len = 0; r = row - BOX_ROW;
+
+		if(r >= 0 && r < box_rows && sh_len[r] >= 0 && !sh_sel[r] && !(editln && r == box_shr)) {
+			p = sh_txt + r * cf_cols; len = sh_len[r];
+		}
+
+		if(row == cr_row) {
+			if(col >= cr_col) {
+				if(p && col - cr_col < cost) {
+					how = 1; cost = col - cr_col;
+				}
+			}
+			else {
+				if(cr_col - col < cost) {
+					how = 2; cost = cr_col - col;
+				}
+
+				if((p || !col) && col + 1 < cost) {
+					how = 3;
+				}
+			}
+		}
+		else if(row > cr_row && (p || !col)) {
+			if((row - cr_row) * CRT_NL_COST + col < cost) {
+				how = 4;
+			}
+		}
+	}
+
+	switch(how)
+	{
+		case 0 : MoveTo(row, col); break;
+		case 2 : putchrx('\b', cr_col - col); break;
+		case 3 : putchr('\r'); cr_col = 0; break;
+		case 4 : putchrx('\n', row - cr_row); cr_col = 0; break;
+	}
+
+	if(how == 1 || how == 3 || how == 4) {
+		while(cr_col < col) {
+			putchr(cr_col < len ? p[cr_col] : ' '); ++cr_col;
+		}
+	}
+
+	cr_row = -1;
+}
+
+/* Tell the cursor position
+   ------------------------
+   After printing something, if it's known -- see Locate().
+*/
+LocateAt(row, col)
+int row, col;
+{
+	/* At the end of the row, the cursor could be on the next one */
+	if(col < cf_cols) {
+		cr_row = row; cr_col = col;
+	}
+	else {
+		cr_row = -1;
+	}
+}
+
 /* Print program layout
    --------------------
 */
@@ -184,17 +407,20 @@ Layout()
 	putstr("te:");
 
 	/* Information layout */
-	CrtLocate(PS_ROW, PS_INF); putstr(PS_TXT);
+	MoveTo(PS_ROW, PS_INF); putstr(PS_TXT);
 
-	/* Max. # of lines */
-	CrtLocate(PS_ROW, PS_LIN_MAX); putint("%04d", cf_mx_lines);
+	for(i = 0; i < PS_FIELDS; ++i) {
+		ps_val[i] = -1;
+	}
 
 	/* # of columns */
-	CrtLocate(PS_ROW, PS_COL_MAX); putint("%02d", 1 + ln_max);
+	MoveTo(PS_ROW, PS_COL_MAX); putnum(1 + ln_max, 2);
+
+	cr_row = -1;
 
 	/* Ruler */
 #if CRT_LONG
-	CrtLocate(BOX_ROW - 1, cf_num);
+	MoveTo(BOX_ROW - 1, cf_num);
 
 	w = cf_cols - cf_num;
 
@@ -212,24 +438,278 @@ Layout()
 	}
 
 	/* System line separator */
-	CrtLocate(cf_rows - 2, 0);
+	MoveTo(cf_rows - 2, 0);
 
 	putchrx(cf_horz_chr, cf_cols);
 #endif
 }
 
+/* Print field of the information line
+   ------------------------------------
+   At column 'col', in 'width' digits. Nothing is printed if the field
+   shows that value already.
+*/
+ShowField(field, col, width, value)
+int field, col, width, value;
+{
+	if(sh_hold) {
+		return;
+	}
+
+	if(ps_val[field] != value) {
+		ps_val[field] = value;
+
+		Locate(PS_ROW, col); putnum(value, width);
+	}
+}
+
+/* Print the information fields of Loop()
+   ---------------------------------------
+   Clipboard status, and line numbers. Nothing is printed if the fields
+   show those values already.
+*/
+ShowInfo()
+{
+	int clp;
+
+	if(sh_hold)
+	{
+		return;
+	}
+
+#if OPT_BLOCK
+
+	clp = (clp_count != 0);
+
+#else
+
+	clp = (*clp_line != 0);
+
+#endif
+
+	if(ps_val[PS_F_CLP] != clp)
+	{
+		ps_val[PS_F_CLP] = clp;
+
+		MoveTo(PS_ROW, PS_CLP); putstr(clp ? "CLP" : "---");
+	}
+
+	ShowField(PS_F_LIN_CUR, PS_LIN_CUR, 4, lp_cur + 1);
+	ShowField(PS_F_LIN_NOW, PS_LIN_NOW, 4, lp_now);
+	ShowField(PS_F_LIN_MAX, PS_LIN_MAX, 4, lp_max);
+}
+
+#if CRT_RESIZE
+
+/* Tell the new screen size
+   ------------------------
+   Called by the adaptation, while it waits for a key, when the screen was
+   resized. The change is done now if a line is being edited, else when
+   Loop() gets the control back -- ie: after the menu.
+*/
+SetScreenSize(rows, cols)
+int rows, cols;
+{
+	rs_rows = rows; rs_cols = cols;
+
+	if(editln) {
+		ResizeScreen();
+	}
+}
+
+/* Resize the screen
+   -----------------
+   Replace the buffers that depend on the screen size, and print all again.
+   The text is not touched: the width doesn't change if a line would not
+   fit in the new one. On errors, the old size is kept.
+*/
+ResizeScreen()
+{
+	int rows, cols, max, box, i;
+	int *len;
+	char *txt, *sel, *dat, *swd, *clp;
+
+	rows = rs_rows; cols = rs_cols; rs_rows = 0;
+
+	if(rows < RS_MIN_ROWS || cols < RS_MIN_COLS) {
+		return;
+	}
+
+	/* Keep the width if a line would not fit */
+	if((max = cols - cf_num - 1) < ln_max) {
+		if(editln && strlen(ln_dat) > max) {
+			max = ln_max;
+		}
+
+		for(i = 0; max < ln_max && i < lp_now; ++i) {
+			if(LineLen(PeekLine(i)) > max) {
+				max = ln_max;
+			}
+		}
+
+		if(max == ln_max) {
+			cols = cf_cols;
+		}
+	}
+
+#if CRT_LONG
+	box = rows - 4;
+#else
+	box = rows - 2;
+#endif
+
+	/* The new buffers */
+	txt = malloc((box + 1) * cols + 1);
+	len = malloc(box * SIZEOF_INT);
+	sel = malloc(box);
+
+	i = (!txt || !len || !sel);
+
+	dat = swd = clp = NULL;
+
+	if(max > ln_max) {
+		i |= !(dat = malloc(max + 2));
+
+#if OPT_SWAP
+
+		i |= !(swd = malloc(max + 2));
+
+#endif
+
+#if OPT_BLOCK
+#else
+
+		i |= !(clp = malloc(max + 1));
+
+#endif
+
+	}
+
+	if(i) {
+		if(txt) free(txt);
+		if(len) free(len);
+		if(sel) free(sel);
+		if(dat) free(dat);
+		if(swd) free(swd);
+		if(clp) free(clp);
+
+		return;
+	}
+
+	/* Replace the old ones */
+	free(sh_txt); sh_txt = txt;
+	free(sh_len); sh_len = len;
+	free(sh_sel); sh_sel = sel;
+
+	if(dat) {
+		if(editln) {
+			strcpy(dat, ln_dat);
+		}
+
+		free(ln_dat); ln_dat = dat;
+
+#if OPT_SWAP
+
+		free(sw_dat); sw_dat = swd;
+
+#endif
+
+#if OPT_BLOCK
+#else
+
+		strcpy(clp, clp_line); free(clp_line); clp_line = clp;
+
+#endif
+
+	}
+
+	cf_rows = rows; cf_cols = cols; box_rows = box; ln_max = max;
+
+	/* The cursor line stays in place, if it's still in the box */
+	if(box_shr >= box_rows) {
+		box_shr = box_rows - 1;
+	}
+
+	RedrawScreen();
+}
+
+#endif
+
+/* Print all the screen again
+   --------------------------
+   The line being edited, if any, is printed from ln_dat.
+*/
+RedrawScreen()
+{
+	ShadowReset();
+
+	Layout();
+	ShowFilename();
+	SysLineEdit(); sysln = 0;
+
+	RefreshScreen();
+}
+
+/* Print the changes in the editor box and information line
+   ---------------------------------------------------------
+   Only what differs from the shadow screen and the information fields is
+   printed -- ie after a macro. The line being edited, if any, is printed
+   from ln_dat.
+*/
+RefreshScreen()
+{
+	int i;
+
+	sh_defer = 0;
+
+	ShowInfo();
+
+	/* The line being edited is printed from ln_dat */
+	i = editln; editln = 0;
+
+	RefreshAll();
+
+	if((editln = i)) {
+		Locate(BOX_ROW + box_shr, cf_num); putstr(ln_dat); CrtClearEol();
+
+		sh_len[box_shr] = -1;
+
+		ShowField(PS_F_COL_NOW, PS_COL_NOW, 2, strlen(ln_dat));
+		ShowField(PS_F_COL_CUR, PS_COL_CUR, 2, box_shc + 1);
+
+		Locate(BOX_ROW + box_shr, cf_num + box_shc);
+	}
+}
+
 /* Print filename
    --------------
+   The field ends before the information layout, so the filename can be
+   clipped on narrow screens.
 */
 ShowFilename()
 {
 	char *s;
+	int w, i;
+
+#if OPT_BATCH
 
-	CrtLocate(PS_ROW, PS_FNAME);
+	/* Nothing is printed in batch mode */
+	if(bt_mode)
+		return;
 
-	putstr((s = CurrentFile()));
+#endif
 
-	putchrx(' ', FILENAME_MAX - strlen(s) - 1);
+	if((w = PS_INF - PS_FNAME - 1) > FILENAME_MAX - 1)
+		w = FILENAME_MAX - 1;
+
+	MoveTo(PS_ROW, PS_FNAME);
+
+	s = CurrentFile();
+
+	for(i = 0; i < w && s[i]; ++i)
+		putchr(s[i]);
+
+	putchrx(' ', w - i);
 }
 
 /* Print message on system line
@@ -239,7 +719,16 @@ ShowFilename()
 SysLine(s)
 char *s;
 {
-	CrtClearLine(cf_rows - 1);
+#if OPT_BATCH
+
+	/* Nothing is printed in batch mode */
+	if(bt_mode) {
+		sysln = 1; return;
+	}
+
+#endif
+
+	MoveTo(cf_rows - 1, 0); CrtClearEol();
 
 	if(s)
 		putstr(s);
@@ -253,6 +742,14 @@ char *s;
 */
 SysLineEdit()
 {
+#if OPT_BATCH
+
+	/* Nothing is printed in batch mode */
+	if(bt_mode)
+		return;
+
+#endif
+
 	SysLine(GetKeyName(K_ESC));	putstr(" = menu");
 }
 
@@ -431,8 +928,12 @@ ClearBox()
 {
 	int i;
 
-	for(i = 0; i < box_rows; ++i)
-		CrtClearLine(BOX_ROW + i);
+	for(i = 0; i < box_rows; ++i) {
+		MoveTo(BOX_ROW + i, 0); CrtClearEol();
+	}
+
+	/* The box is going to be used for other things */
+	ShadowReset();
 }
 
 /* Print centered text on the screen
@@ -441,53 +942,325 @@ ClearBox()
 CenterText(row, txt)
 int row; char *txt;
 {
-	CrtLocate(row, (cf_cols - strlen(txt)) / 2);
+	MoveTo(row, (cf_cols - strlen(txt)) / 2);
 
 	putstr(txt);
 }
 
-#if OPT_BLOCK
-
-/* Refresh block selection in editor box
+/* Forget the contents of the editor box
    -------------------------------------
-   Set 'sel' to NZ for reverse print, else Z for normal print.
+   The shadow screen keeps the characters printed on each row of the editor
+   box, so RefreshRow() can print only the ones that changed. Call this
+   when the box was modified by other means.
+*/
+ShadowReset()
+{
+	int i;
+
+	for(i = 0; i < box_rows; ++i) {
+		sh_len[i] = -1; sh_sel[i] = 0;
+	}
+}
+
+/* Print characters of a string
+   ----------------------------
+   From position 'from' to 'to' - 1.
+*/
+PrintSpan(s, from, to)
+char *s; int from, to;
+{
+	int ch;
+
+	ch = s[to]; s[to] = '\0';
+
+	putstr(s + from);
+
+	s[to] = ch;
+}
+
+/* Refresh a row of the editor box
+   -------------------------------
+   Print line # on box row 'row', or clear the row if there is no such line.
+   Set 'sel' to NZ if the line is selected.
 */
-RefreshBlock(row, sel)
-int row, sel;
+RefreshRow(row, line, sel)
+int row, line, sel;
 {
-	int i, line;
+	int n, len, k, e, old;
+	char *s, *p, format[4];
+
+#if OPT_STATS
 
-	line = GetFirstLine() + row;
+	unsigned int out;
+
+#endif
 
-	for(i = row; i < box_rows; ++i) {
-		if(line >= blk_start) {
-			if(line <= blk_end) {
+	/* Build the row in the work row of the shadow screen */
+	s = sh_txt + box_rows * cf_cols;
+	n = 0;
+
+	if(line < lp_now) {
+
+		if(cf_num) {
+			strcpy(format, "%?d");
+			format[1] = '0' + cf_num - 1;
+
+			/* The lines array can grow beyond cf_mx_lines: print the last digits only */
+			for(len = 1, k = cf_num - 1; k; --k) {
+				len *= 10;
+			}
+
+			sprintf(s, format, (line + 1) % len);
+
+			s[(n = cf_num - 1)] = cf_lnum_chr; ++n;
+		}
+
+		p = PeekLine(line);
+
+		memcpy(s + n, p, (len = LineLen(p)));
+
+		n += len;
+
+#if OPT_BLOCK
+
+		if(sel) {
 #if CRT_CAN_REV
-				CrtLocate(BOX_ROW + i, cf_num);
-				CrtClearEol();
+			s[n++] = ' ';
+#else
+			while(n < cf_cols - 1) {
+				s[n++] = ' ';
+			}
 
-				if(sel) {
-					CrtReverse(1);
-				}
+			s[n++] = BLOCK_CHR;
 
-				putstr(lp_arr[line]);
-				putchr(' ');
+			sel = 0;
+#endif
+		}
 
-				if(sel) {
+#endif
+
+	}
+	else {
+		sel = 0;
+	}
+
+	/* Trailing spaces are the same as a clear row, unless in reverse */
+	if(!sel) {
+		while(n && s[n - 1] == ' ') {
+			--n;
+		}
+	}
+
+	p = sh_txt + row * cf_cols;
+	old = sh_len[row];
+
+	/* Nothing to do if the row was printed already as selected */
+	if(sel && sh_sel[row] && old == n && !memcmp(s, p, n)) {
+		return;
+	}
+
+#if OPT_STATS
+
+	out = st_now[ST_OUT];
+
+#endif
+
+	if(old < 0 || sel || sh_sel[row]) {
+
+		/* Print the whole row */
+		Locate(BOX_ROW + row, 0); CrtClearEol();
+
+#if CRT_CAN_REV
+
+		if(sel) {
+			PrintSpan(s, 0, cf_num);
+
+			CrtReverse(1);
+			PrintSpan(s, cf_num, n);
+			CrtReverse(0);
+		}
+		else {
+			PrintSpan(s, 0, n);
+		}
 
-					CrtReverse(0);
-				}
 #else
-				CrtLocate(BOX_ROW + i, cf_cols - 1); putchr(sel ? BLOCK_CHR : ' ');
+
+		PrintSpan(s, 0, n);
+
 #endif
+
+		LocateAt(BOX_ROW + row, n);
+	}
+	else {
+
+		/* Print the changed characters only, in spans: Locate() prints
+		   the unchanged ones between them, if it's cheaper */
+		for(k = 0; k < n; ) {
+			if(s[k] == (k < old ? p[k] : ' ')) {
+				++k; continue;
+			}
+
+			for(e = k + 1; e < n && s[e] != (e < old ? p[e] : ' '); ++e)
+				;
+
+			Locate(BOX_ROW + row, k);
+
+			PrintSpan(s, k, e);
+
+			LocateAt(BOX_ROW + row, (k = e));
+		}
+
+		/* Clear the rest of the row, if the old one was longer */
+		for(k = n; k < old && p[k] == ' '; ++k)
+			;
+
+		if(k < old) {
+			Locate(BOX_ROW + row, n); CrtClearEol();
+
+			LocateAt(BOX_ROW + row, n);
+		}
+	}
+
+#if OPT_STATS
+
+	if(out != st_now[ST_OUT]) {
+		++st_now[ST_ROW];
+	}
+
+#endif
+
+	/* Update the shadow screen */
+	memcpy(p, s, n);
+
+	sh_len[row] = n; sh_sel[row] = sel;
+}
+
+/* Scroll down the editor box from row
+   -----------------------------------
+   The rows from 'row' go down, the last one is lost, and 'row' is left
+   blank. The rows below the box are kept in place, by deleting the last
+   row before inserting the new one.
+
+   Does nothing if the CRT can't insert and delete lines: Refresh() will
+   print the changes anyway.
+*/
+ScrollBoxDown(row)
+int row;
+{
+#if CRT_CAN_INS
+
+	int i;
+
+	if(sh_hold) {
+		return;
+	}
+
+	if(row < box_rows - 1) {
+		CrtDelLine(BOX_ROW + box_rows - 1);
+		CrtInsLine(BOX_ROW + row);
+
+		/* Update the shadow screen */
+		for(i = box_rows - 1; i > row; --i) {
+			ShadowCopy(i, i - 1);
+		}
+
+		sh_len[row] = sh_sel[row] = 0;
+	}
+
+#endif
+}
+
+/* Scroll up the editor box from row
+   ---------------------------------
+   The rows below 'row' go up, 'row' is lost, and the last row is left
+   blank. See ScrollBoxDown().
+*/
+ScrollBoxUp(row)
+int row;
+{
+#if CRT_CAN_INS
+
+	int i;
+
+	if(sh_hold) {
+		return;
+	}
+
+	if(row < box_rows - 1) {
+		CrtDelLine(BOX_ROW + row);
+		CrtInsLine(BOX_ROW + box_rows - 1);
+
+		/* Update the shadow screen */
+		for(i = row; i < box_rows - 1; ++i) {
+			ShadowCopy(i, i + 1);
+		}
+
+		sh_len[i] = sh_sel[i] = 0;
+	}
+
+#endif
+}
+
+#if CRT_CAN_INS
+
+/* Copy a row of the shadow screen
+   -------------------------------
+*/
+ShadowCopy(to, from)
+int to, from;
+{
+	if((sh_len[to] = sh_len[from]) > 0) {
+		memcpy(sh_txt + to * cf_cols, sh_txt + from * cf_cols, sh_len[from]);
+	}
+
+	sh_sel[to] = sh_sel[from];
+}
+
+#endif
+
+#if OPT_BLOCK
+
+/* Refresh block selection in editor box
+   -------------------------------------
+   Print only the rows whose selection changed: the block was 'count' lines
+   from line 'start' (Z if none), and now it's the one in blk_... variables.
+*/
+RefreshBlock(start, count)
+int start, count;
+{
+	int i, line, was, sel, wait;
+
+	if(sh_hold) {
+		return;
+	}
+
+	line = GetFirstLine();
+
+	wait = 0;
+
+	for(i = 0; i < box_rows && line < lp_now; ++i) {
+		was = (count && line >= start && line < start + count);
+		sel = (blk_count && line >= blk_start && line <= blk_end);
+
+		if(was != sel) {
+			/* Leave the row for later if there are keys waiting -- see Refresh() */
+			if(!wait) {
+				wait = CrtStat();
+			}
+
+			if(wait && i != box_shr) {
+				sh_defer = 1;
 			}
 			else {
-				break;
+				RefreshRow(i, line, sel);
 			}
 		}
 
 		++line;
 	}
+
+	/* Other functions move the cursor on their own -- see Refresh() */
+	cr_row = -1;
 }
 
 #endif
@@ -499,70 +1272,60 @@ int row, sel;
 Refresh(row, line)
 int row, line;
 {
-	int i;
-	char *format;
+	int i, sel, wait;
 
 #if OPT_BLOCK
 
-	int blk, sel;
+	int blk;
 
 	blk = (blk_count && blk_start <= GetLastLine() && blk_end >= GetFirstLine());
-	sel = 0;
 
 #endif
 
-	if(cf_num) {
-		format = "%?d";
-		format[1] = '0' + cf_num - 1;
+	/* Nothing is printed while a macro runs -- see RefreshScreen() */
+	if(sh_hold) {
+		return;
 	}
 
+	wait = 0;
+
 	for(i = row; i < box_rows; ++i)
 	{
-		CrtClearLine(BOX_ROW + i);
-
-		if(line < lp_now) {
-
-			if(cf_num) {
-						putint(format, line + 1);
-						putchr(cf_lnum_chr);
-			}
-
-#if OPT_BLOCK
+		/* If there are keys waiting, leave the rows for later, but the
+		   cursor one: the keys will change them again. Loop() will catch
+		   up when the keyboard is idle. */
+		if(!wait) {
+			wait = CrtStat();
+		}
 
-			if(blk) {
-				if(line >= blk_start) {
-					if(line <= blk_end) {
-#if CRT_CAN_REV
-						CrtReverse((sel = 1));
-#else
-						sel = 1;
-#endif
-					}
-				}
-			}
+		if(wait && i != box_shr) {
+			sh_defer = 1; ++line; continue;
+		}
 
-#endif
+		/* The line being edited is printed by BfEdit() */
+		if(editln && i == box_shr) {
+			++line; continue;
+		}
 
-			putstr(lp_arr[line++]);
+		sel = 0;
 
 #if OPT_BLOCK
 
-			if(sel) {
-#if CRT_CAN_REV
-				putchr(' ');
-
-				CrtReverse((sel = 0));
-#else
-				sel = 0;
-
-				CrtLocate(BOX_ROW + i, cf_cols - 1); putchr(BLOCK_CHR);
-#endif
+		if(blk) {
+			if(line >= blk_start) {
+				if(line <= blk_end) {
+					sel = 1;
+				}
 			}
+		}
 
 #endif
 
-		}
+		RefreshRow(i, line++, sel);
 	}
+
+	/* Other functions move the cursor on their own */
+	cr_row = -1;
 }
 
 /* Refresh editor box
@@ -601,20 +1364,16 @@ Menu()
 			CenterText(row++, "Open");
 			CenterText(row++, "Save");
 			CenterText(row++, "save As");
-#if OPT_MACRO
 			CenterText(row++, "Insert");
-#endif			
 			CenterText(row++, "Help");
+#if OPT_STATS
+			CenterText(row++, "sTatistics");
+#endif
 			CenterText(row++, "aBout te");
 			CenterText(row  , "eXit te");
 #else
-#if OPT_MACRO
 			CenterText(row++, "New     Open  Save      Save As");
 			CenterText(row++, "Insert  Help  aBout te  eXit te");
-#else
-			CenterText(row++, "New   Open      Save     Save As");
-			CenterText(row++, "Help  aBout te  eXit te         ");
-#endif			
 #endif
 			menu = 0;
 		}
@@ -638,10 +1397,11 @@ Menu()
 			case 'O'   : run = MenuOpen(); break;
 			case 'S'   : run = MenuSave(); break;
 			case 'A'   : run = MenuSaveAs(); break;
-#if OPT_MACRO
 			case 'I'   : run = MenuInsert(); break;
-#endif
 			case 'B'   : MenuAbout(); menu = 1; break;
+#if OPT_STATS
+			case 'T'   : MenuStats(); menu = 1; break;
+#endif
 			case 'H'   : MenuHelp(); menu = 1; break;
 			case 'X'   : run = stay = MenuExit(); break;
 			case K_ESC : run = 0; break;
@@ -739,8 +1499,6 @@ MenuSaveAs()
 	return 1;
 }
 
-#if OPT_MACRO
-
 /* Menu option: Insert
    -------------------
    Return Z to quit the menu.
@@ -748,19 +1506,44 @@ MenuSaveAs()
 MenuInsert()
 {
 	char fn[FILENAME_MAX];
+	int n;
 
 	fn[0] = 0;
 
 	if(SysLineFile(fn))
 	{
-		return MacroRunFile(fn, 1);
+#if OPT_BLOCK
+
+		/* The selection would be out of place */
+		blk_start = blk_end = -1;
+		blk_count = 0;
+
+#endif
+
+		/* The rest of the current file is read first by InsertFile(): do
+		   it now, to count only the inserted lines */
+		if(ReadAll())
+			return 0;
+
+		/* The lines go before the current one, as in LoopPaste() */
+		n = lp_now;
+
+		InsertFile(fn);
+
+		if((n = lp_now - n)) {
+			lp_cur += n;
+
+			box_shr = (box_shr + n < box_rows ? box_shr + n : box_rows - 1);
+
+			box_shc = 0;
+		}
+
+		return 0;
 	}
 
 	return 1;
 }
 
-#endif
-
 /* Menu option: Help
    -----------------
 */
@@ -771,7 +1554,7 @@ MenuHelp()
 
 	ClearBox();
 
-	CrtLocate(BOX_ROW + 1, 0);
+	MoveTo(BOX_ROW + 1, 0);
 
 	putln("HELP:\n");
 
@@ -873,6 +1656,78 @@ MenuAbout()
 	SysLineBack(NULL);
 }
 
+#if OPT_STATS
+
+/* Menu option: Statistics
+   -----------------------
+   Show the work done for the last key in the editor, before the menu,
+   and the free bytes in line storage.
+*/
+MenuStats()
+{
+	int row, col;
+
+#if CRT_LONG
+	row = BOX_ROW + 1;
+
+	ClearBox();
+
+	CenterText(row++, "STATISTICS");
+	row++;
+#else
+	row = BOX_ROW;
+
+	ClearBox();
+#endif
+
+	CenterText(row++, "            Last  Max. Total");
+	MenuStatsRow(row++, "Output", ST_OUT);
+	MenuStatsRow(row++, "Locate", ST_LOC);
+	MenuStatsRow(row++, "Rows", ST_ROW);
+	MenuStatsRow(row++, "Memory", ST_MEM);
+
+	MoveTo(row, (col = (cf_cols - 28) / 2)); putstr("Keys");
+	MoveTo(row++, col + 23);                 StatNum(st_keys);
+
+	MoveTo(row, col);      putstr("Free");
+	MoveTo(row, col + 23); StatNum(LineFreeBytes());
+
+	SysLineBack(NULL);
+}
+
+/* Print a row of statistics
+   -------------------------
+*/
+MenuStatsRow(row, name, i)
+int row; char *name; int i;
+{
+	int col;
+
+	MoveTo(row, (col = (cf_cols - 28) / 2)); putstr(name);
+
+	MoveTo(row, col + 11); StatNum(st_last[i]);
+	putchr(' ');           StatNum(st_top[i]);
+	putchr(' ');           StatNum(st_tot[i]);
+}
+
+/* Print a counter of the statistics
+   ---------------------------------
+   In 5 digits, or as ***** if it doesn't fit, or if it stopped at the max.
+   value -- see StatKey().
+*/
+StatNum(value)
+unsigned int value;
+{
+	if(value == -1 || value / 10 > 9999) {
+		putstr("*****");
+	}
+	else {
+		putnum(value, 5);
+	}
+}
+
+#endif
+
 /* Menu option: Quit program
    -------------------------
 */
@@ -887,4 +1742,3 @@ MenuExit()
 	return 0;
 }
 
-
\ No newline at end of file